@@ -0,0 +1,257 @@
+/**
+ * @file Benchmark.cpp
+ *
+ * Copyright(C), 2017 - 2018, Lxzh Tech. Co., Ltd. ALL RIGHTS RESERVED.
+ *
+ * @brief throughput of fp16_t methods, build switches are compared by building this file
+ *        once per switch, see the compile commands at the end of the file
+ *
+ * @version 1.0
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "fp16_t.h"
+#include "fp16_array.h"
+#include "fp16_simd.h"
+
+/**
+ *@ingroup benchmark basic parameter
+ *@brief   elements of every benchmark array, the arrays stay in L2
+ */
+#define BENCH_SIZE                     (1 << 16)
+/**
+ *@ingroup benchmark basic parameter
+ *@brief   runs of every benchmark, the fastest run is reported
+ */
+#define BENCH_RUNS                     (20)
+
+/**
+ *@ingroup benchmark static method
+ *@brief   xorshift32 random bits, the sequence is the same on every run
+ */
+static uint32_t BenchRand(){
+    static uint32_t state = 0x12345678u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/**
+ *@ingroup benchmark static method
+ *@param [in] name  printed name
+ *@param [in] n     elements handled by one run of func
+ *@param [in] func  one run
+ *@brief   Print the fastest of BENCH_RUNS runs of func in ns per element
+ */
+template <typename Func> static void BenchRun(const char *name, size_t n, const Func &func){
+    double best = 0.0;
+    for (int r = 0; r < BENCH_RUNS; r++){
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        func();
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+        best = (r == 0 || ns < best) ? ns : best;
+    }
+    printf("  %-32s %8.2f ns\n", name, best);
+}
+
+/**
+ *@ingroup benchmark static method
+ *@param [out] src   fp16_t bits of a kind
+ *@param [in]  kind  0: random bits, 1: denormals only, 2: normals only
+ */
+static void BenchFp16Bits(std::vector<uint16_t> &src, int kind){
+    for (size_t i = 0; i < src.size(); i++){
+        uint16_t val = (uint16_t)BenchRand();
+        if (kind == 1){
+            val &= (FP16_SIGN_MASK | FP16_MAN_MASK);
+        }
+        else if (kind == 2 && FP16_EXTRAC_EXP(val) == 0){
+            val |= FP16_MAN_HIDE_BIT;
+        }
+        src[i] = val;
+    }
+}
+
+/********************************************************************************************/
+/*                         fp16ToFloat/fp16ToDouble, table vs arithmetic                     */
+/********************************************************************************************/
+static void BenchDecode(){
+#ifdef FP16_DECODE_TABLE
+    printf("fp16ToFloat/fp16ToDouble, FP16_DECODE_TABLE on:\n");
+#else
+    printf("fp16ToFloat/fp16ToDouble, FP16_DECODE_TABLE off:\n");
+#endif
+    static const char *kinds[] = {"random bits", "denormals", "normals"};
+    std::vector<uint16_t> src(BENCH_SIZE);
+    std::vector<float> f(BENCH_SIZE);
+    std::vector<double> d(BENCH_SIZE);
+    char name[64];
+    //the table is filled on first use, not in the timed loop
+    f[0] = fp16ToFloat(src[0]);
+    d[0] = fp16ToDouble(src[0]);
+    for (int kind = 0; kind < 3; kind++){
+        BenchFp16Bits(src, kind);
+        snprintf(name, sizeof(name), "fp16ToFloat, %s", kinds[kind]);
+        BenchRun(name, src.size(), [&](){
+            for (size_t i = 0; i < src.size(); i++){
+                f[i] = fp16ToFloat(src[i]);
+            }
+        });
+        snprintf(name, sizeof(name), "fp16ToDouble, %s", kinds[kind]);
+        BenchRun(name, src.size(), [&](){
+            for (size_t i = 0; i < src.size(); i++){
+                d[i] = fp16ToDouble(src[i]);
+            }
+        });
+    }
+}
+
+/********************************************************************************************/
+/*                          fp16_t / fp16_t, integer engine vs float                         */
+/********************************************************************************************/
+/**
+ *@ingroup benchmark static method
+ *@brief   fp16Div before fp16_div was wired in: mantissas are aligned by a shift loop,
+ *         divided as float and narrowed by fp16_t::operator=(const float&)
+ */
+static uint16_t LegacyFp16Div(uint16_t v1, uint16_t v2){
+    uint16_t ret;
+    if (FP16_IS_ZERO(v2)){
+        uint16_t s_ret = FP16_EXTRAC_SIGN(v1) ^ FP16_EXTRAC_SIGN(v2);
+        ret = FP16_CONSTRUCTOR(s_ret, FP16_MAX_EXP - 1, FP16_MAX_MAN);
+    }
+    else if (FP16_IS_ZERO(v1)){
+        ret = 0u;
+    }
+    else{
+        uint16_t s_a, s_b;
+        int16_t e_a, e_b;
+        uint16_t ma_tmp, mb_tmp;
+        ExtractFP16(v1, &s_a, &e_a, &ma_tmp);
+        ExtractFP16(v2, &s_b, &e_b, &mb_tmp);
+        uint64_t m_a = ma_tmp;
+        uint64_t m_b = mb_tmp;
+        if (e_a > e_b){
+            for (int i = 0; i < e_a - e_b; i++){
+                m_a = m_a << 1;
+            }
+        }
+        else if (e_a < e_b){
+            for (int i = 0; i < e_b - e_a; i++){
+                m_b = m_b << 1;
+            }
+        }
+        float m_div = (float)(m_a * 1.0f / m_b);
+        fp16_t fp_div;
+        fp_div = m_div;
+        ret = fp_div.val;
+        if (s_a != s_b){
+            ret |= FP16_SIGN_MASK;
+        }
+    }
+    return ret;
+}
+
+static void BenchDivide(){
+    printf("fp16_t division, random operands:\n");
+    std::vector<uint16_t> a(BENCH_SIZE), b(BENCH_SIZE), c(BENCH_SIZE);
+    BenchFp16Bits(a, 0);
+    BenchFp16Bits(b, 0);
+    BenchRun("old float round-trip", a.size(), [&](){
+        for (size_t i = 0; i < a.size(); i++){
+            c[i] = LegacyFp16Div(a[i], b[i]);
+        }
+    });
+    BenchRun("operator/", a.size(), [&](){
+        for (size_t i = 0; i < a.size(); i++){
+            fp16_t x(a[i]);
+            c[i] = (x / fp16_t(b[i])).val;
+        }
+    });
+    static const char *levels[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+    char name[64];
+    for (int level = SIMD_LEVEL_SCALAR; level < SIMD_LEVEL_RESERVED; level++){
+        SetFp16SimdLevel((fp16SimdLevel_t)level);
+        if (GetFp16SimdLevel() != level){
+            break;
+        }
+        snprintf(name, sizeof(name), "fp16DivN, %s", levels[level]);
+        BenchRun(name, a.size(), [&](){
+            fp16DivN(a.data(), b.data(), c.data(), a.size());
+        });
+    }
+    SetFp16SimdLevel(SIMD_LEVEL_RESERVED);
+}
+
+/********************************************************************************************/
+/*                      fp16_t operators in user loops, out of line vs inline                 */
+/********************************************************************************************/
+static void BenchLoops(){
+#ifdef FP16_HEADER_ONLY
+    printf("fp16_t loops, FP16_HEADER_ONLY on:\n");
+#else
+    printf("fp16_t loops, FP16_HEADER_ONLY off:\n");
+#endif
+    std::vector<fp16_t> a(BENCH_SIZE), b(BENCH_SIZE), c(BENCH_SIZE), d(BENCH_SIZE);
+    std::vector<float> f(BENCH_SIZE);
+    for (size_t i = 0; i < a.size(); i++){
+        a[i] = (float)((int)(BenchRand() % 2000) - 1000) / 100.0f;
+        b[i] = (float)((int)(BenchRand() % 2000) - 1000) / 100.0f;
+        c[i] = (float)((int)(BenchRand() % 2000) - 1000) / 100.0f;
+        f[i] = (float)((int)(BenchRand() % 2000) - 1000) / 100.0f;
+    }
+    BenchRun("d = a * b + c", a.size(), [&](){
+        for (size_t i = 0; i < a.size(); i++){
+            d[i] = a[i] * b[i] + c[i];
+        }
+    });
+    BenchRun("d = a + b", a.size(), [&](){
+        for (size_t i = 0; i < a.size(); i++){
+            d[i] = a[i] + b[i];
+        }
+    });
+    BenchRun("m = a > m ? a : m", a.size(), [&](){
+        fp16_t m = a[0];
+        for (size_t i = 1; i < a.size(); i++){
+            m = (a[i] > m) ? a[i] : m;
+        }
+        d[0] = m;
+    });
+    BenchRun("s += float(a)", a.size(), [&](){
+        float sum = 0.0f;
+        for (size_t i = 0; i < a.size(); i++){
+            sum += (float)a[i];
+        }
+        f[0] = sum;
+    });
+    BenchRun("d = float", a.size(), [&](){
+        for (size_t i = 0; i < a.size(); i++){
+            d[i] = f[i];
+        }
+    });
+}
+
+int main(){
+    BenchDecode();
+    BenchDivide();
+    BenchLoops();
+    return 0;
+}
+
+/***compile command, run from the directory of this file:*********************************************************/
+/***default build:                                                                                                    */
+/***g++ -std=c++11 -O2 -Ifp16 Benchmark.cpp fp16/fp16_t.cc fp16/fp16div.cc fp16/fp16_table.cc fp16/fp16_array.cc         */
+/***    fp16/fp16_simd.cc -o bench*************************************************************************************/
+/***table decode:                                                                                                     */
+/***g++ -std=c++11 -O2 -DFP16_DECODE_TABLE -Ifp16 Benchmark.cpp fp16/fp16_t.cc fp16/fp16div.cc fp16/fp16_table.cc       */
+/***    fp16/fp16_array.cc fp16/fp16_simd.cc -o bench_table*************************************************************/
+/***header-only fp16_t, fp16_t.cc and fp16div.cc are included by fp16_t.h:                                            */
+/***g++ -std=c++17 -O2 -DFP16_HEADER_ONLY -Ifp16 Benchmark.cpp fp16/fp16_table.cc fp16/fp16_array.cc fp16/fp16_simd.cc   */
+/***    -o bench_inline************************************************************************************************/
+/*********************************************************************************************************************/
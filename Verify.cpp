@@ -0,0 +1,370 @@
+/**
+ * @file Verify.cpp
+ *
+ * Copyright(C), 2017 - 2018, Lxzh Tech. Co., Ltd. ALL RIGHTS RESERVED.
+ *
+ * @brief exhaustive check of the fp16_t array math and integer conversion kernels over all
+ *        65536 inputs, every SIMD level the cpu supports and every fp16RoundMode_t, see the
+ *        compile commands at the end of the file. The exit status is the count of failed checks
+ *
+ * @version 1.0
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <vector>
+#include "fp16_t.h"
+#include "fp16_array.h"
+#include "fp16_math.h"
+#include "fp16_simd.h"
+
+/**
+ *@ingroup verify basic parameter
+ *@brief   count of fp16_t values
+ */
+#define VERIFY_SIZE                    (0x10000)
+
+typedef void (*fp16ArrayFunc_t)(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode);
+typedef fp16_t (*fp16ScalarFunc_t)(fp16_t fp);
+typedef double (*libmFunc_t)(double x);
+
+static const char *g_LevelNames[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+static const char *g_ModeNames[] = {"nearest", "ceiling", "floor", "truncated"};
+
+/**
+ *@ingroup verify static method
+ *@param [in]  libm        reference function in double
+ *@param [in]  throughFloat the double result is narrowed to float first, as hf_sin does
+ *@param [in]  roundMode   round mode of the last narrowing
+ *@param [out] ref         reference of every fp16_t value
+ *@brief   Reference results: libm in double, rounded once to fp16_t under roundMode
+ */
+static void VerifyReference(libmFunc_t libm, bool throughFloat, fp16RoundMode_t roundMode, std::vector<uint16_t> &ref){
+    std::vector<double> d(VERIFY_SIZE);
+    std::vector<float> f(VERIFY_SIZE);
+    for (uint32_t i = 0; i < VERIFY_SIZE; i++){
+        d[i] = libm(fp16ToDouble((uint16_t)i));
+        f[i] = (float)d[i];
+    }
+    if (throughFloat){
+        floatToFp16N(f.data(), ref.data(), VERIFY_SIZE, roundMode);
+    }
+    else{
+        doubleToFp16N(d.data(), ref.data(), VERIFY_SIZE, roundMode);
+    }
+}
+
+/**
+ *@ingroup verify static method
+ *@brief   Count and print the first mismatches of got against ref from index first on
+ *@return  Return count of mismatches
+ */
+static long VerifyCompare(const char *what, const uint16_t *got, const uint16_t *ref, uint32_t first, uint32_t end){
+    long bad = 0;
+    for (uint32_t i = first; i < end; i++){
+        if (got[i] != ref[i]){
+            if (bad < 4){
+                printf("    %s: input 0x%04x got 0x%04x expected 0x%04x\n", what, i, got[i], ref[i]);
+            }
+            bad++;
+        }
+    }
+    return bad;
+}
+
+/**
+ *@ingroup verify static method
+ *@param [in] name        printed name
+ *@param [in] arrayFunc   array kernel
+ *@param [in] scalarFunc  table method the kernel is bit-exact with under g_RoundMode
+ *@param [in] libm        reference function in double
+ *@param [in] throughFloat see VerifyReference
+ *@brief   Check arrayFunc over all inputs at every SIMD level and round mode: whole array,
+ *         an unaligned odd length slice for the tails, and in place. ROUND_TO_NEAREST and
+ *         ROUND_BY_TRUNCATED are also checked against scalarFunc under that g_RoundMode
+ *@return  Return count of failed checks
+ */
+static int VerifyUnary(const char *name, fp16ArrayFunc_t arrayFunc, fp16ScalarFunc_t scalarFunc, libmFunc_t libm, bool throughFloat){
+    std::vector<uint16_t> src(VERIFY_SIZE), dst(VERIFY_SIZE), ref(VERIFY_SIZE), scalar(VERIFY_SIZE);
+    for (uint32_t i = 0; i < VERIFY_SIZE; i++){
+        src[i] = (uint16_t)i;
+    }
+    int failed = 0;
+    long total = 0;
+    char what[96];
+    for (int mode = ROUND_TO_NEAREST; mode < ROUND_MODE_RESERVED; mode++){
+        fp16RoundMode_t roundMode = (fp16RoundMode_t)mode;
+        VerifyReference(libm, throughFloat, roundMode, ref);
+        if (roundMode == ROUND_TO_NEAREST || roundMode == ROUND_BY_TRUNCATED){
+            g_RoundMode = roundMode;
+            for (uint32_t i = 0; i < VERIFY_SIZE; i++){
+                scalar[i] = scalarFunc(fp16_t((uint16_t)i)).val;
+            }
+            g_RoundMode = ROUND_TO_NEAREST;
+            snprintf(what, sizeof(what), "%s table, %s", name, g_ModeNames[mode]);
+            long bad = VerifyCompare(what, scalar.data(), ref.data(), 0, VERIFY_SIZE);
+            failed += (bad != 0);
+            total += bad;
+        }
+        for (int level = SIMD_LEVEL_SCALAR; level < SIMD_LEVEL_RESERVED; level++){
+            SetFp16SimdLevel((fp16SimdLevel_t)level);
+            if (GetFp16SimdLevel() != level){
+                break;
+            }
+            snprintf(what, sizeof(what), "%s %s, %s", name, g_LevelNames[level], g_ModeNames[mode]);
+            arrayFunc(src.data(), dst.data(), VERIFY_SIZE, roundMode);
+            long bad = VerifyCompare(what, dst.data(), ref.data(), 0, VERIFY_SIZE);
+            //odd length from an odd address leaves a tail at every vector width
+            dst.assign(VERIFY_SIZE, 0);
+            arrayFunc(src.data() + 1, dst.data() + 1, VERIFY_SIZE - 4, roundMode);
+            bad += VerifyCompare(what, dst.data(), ref.data(), 1, VERIFY_SIZE - 3);
+            dst = src;
+            arrayFunc(dst.data(), dst.data(), VERIFY_SIZE, roundMode);
+            bad += VerifyCompare(what, dst.data(), ref.data(), 0, VERIFY_SIZE);
+            failed += (bad != 0);
+            total += bad;
+        }
+        SetFp16SimdLevel(SIMD_LEVEL_RESERVED);
+    }
+    printf("%-12s %s, %ld mismatches\n", name, failed ? "FAILED" : "ok", total);
+    return failed;
+}
+
+/********************************************************************************************/
+/*                                      exp/log                                             */
+/********************************************************************************************/
+static double LibmExp(double x){
+    return std::exp(x);
+}
+static double LibmLn(double x){
+    return std::log(x);
+}
+static double LibmLog2(double x){
+    return std::log2(x);
+}
+static double LibmLog10(double x){
+    return std::log10(x);
+}
+
+static int VerifyExpLog(){
+    int failed = 0;
+    failed += VerifyUnary("fp16ExpN", fp16ExpN, hf_exp, LibmExp, false);
+    failed += VerifyUnary("fp16LnN", fp16LnN, hf_ln, LibmLn, false);
+    failed += VerifyUnary("fp16Log2N", fp16Log2N, hf_log2, LibmLog2, false);
+    failed += VerifyUnary("fp16Log10N", fp16Log10N, hf_log10, LibmLog10, false);
+    return failed;
+}
+
+/********************************************************************************************/
+/*                                      sin/cos                                             */
+/********************************************************************************************/
+static double LibmSin(double x){
+    return std::sin(x);
+}
+static double LibmCos(double x){
+    return std::cos(x);
+}
+
+/**
+ *@ingroup verify static method
+ *@brief   Check fp16SinCosN against both references at every SIMD level and round mode, with
+ *         sinDst and then cosDst in place of src, and hf_sincos/hf_sincosN against the same
+ *         references under ROUND_TO_NEAREST and ROUND_BY_TRUNCATED
+ *@return  Return count of failed checks
+ */
+static int VerifySinCos(){
+    std::vector<uint16_t> src(VERIFY_SIZE), s(VERIFY_SIZE), c(VERIFY_SIZE);
+    std::vector<uint16_t> sinRef(VERIFY_SIZE), cosRef(VERIFY_SIZE);
+    for (uint32_t i = 0; i < VERIFY_SIZE; i++){
+        src[i] = (uint16_t)i;
+    }
+    int failed = 0;
+    long total = 0;
+    char what[96];
+    for (int mode = ROUND_TO_NEAREST; mode < ROUND_MODE_RESERVED; mode++){
+        fp16RoundMode_t roundMode = (fp16RoundMode_t)mode;
+        VerifyReference(LibmSin, true, roundMode, sinRef);
+        VerifyReference(LibmCos, false, roundMode, cosRef);
+        for (int level = SIMD_LEVEL_SCALAR; level < SIMD_LEVEL_RESERVED; level++){
+            SetFp16SimdLevel((fp16SimdLevel_t)level);
+            if (GetFp16SimdLevel() != level){
+                break;
+            }
+            snprintf(what, sizeof(what), "fp16SinCosN %s, %s", g_LevelNames[level], g_ModeNames[mode]);
+            fp16SinCosN(src.data() + 1, s.data() + 1, c.data() + 1, VERIFY_SIZE - 4, roundMode);
+            long bad = VerifyCompare(what, s.data(), sinRef.data(), 1, VERIFY_SIZE - 3);
+            bad += VerifyCompare(what, c.data(), cosRef.data(), 1, VERIFY_SIZE - 3);
+            s = src;
+            fp16SinCosN(s.data(), s.data(), c.data(), VERIFY_SIZE, roundMode);
+            bad += VerifyCompare(what, s.data(), sinRef.data(), 0, VERIFY_SIZE);
+            bad += VerifyCompare(what, c.data(), cosRef.data(), 0, VERIFY_SIZE);
+            c = src;
+            fp16SinCosN(c.data(), s.data(), c.data(), VERIFY_SIZE, roundMode);
+            bad += VerifyCompare(what, s.data(), sinRef.data(), 0, VERIFY_SIZE);
+            bad += VerifyCompare(what, c.data(), cosRef.data(), 0, VERIFY_SIZE);
+            failed += (bad != 0);
+            total += bad;
+        }
+        SetFp16SimdLevel(SIMD_LEVEL_RESERVED);
+        if (roundMode != ROUND_TO_NEAREST && roundMode != ROUND_BY_TRUNCATED){
+            continue;
+        }
+        g_RoundMode = roundMode;
+        for (uint32_t i = 0; i < VERIFY_SIZE; i++){
+            fp16_t sinVal, cosVal;
+            hf_sincos(fp16_t((uint16_t)i), &sinVal, &cosVal);
+            s[i] = sinVal.val;
+            c[i] = cosVal.val;
+        }
+        snprintf(what, sizeof(what), "hf_sincos, %s", g_ModeNames[mode]);
+        long bad = VerifyCompare(what, s.data(), sinRef.data(), 0, VERIFY_SIZE);
+        bad += VerifyCompare(what, c.data(), cosRef.data(), 0, VERIFY_SIZE);
+        hf_sincosN((const fp16_t *)src.data(), (fp16_t *)s.data(), (fp16_t *)c.data(), VERIFY_SIZE);
+        snprintf(what, sizeof(what), "hf_sincosN, %s", g_ModeNames[mode]);
+        bad += VerifyCompare(what, s.data(), sinRef.data(), 0, VERIFY_SIZE);
+        bad += VerifyCompare(what, c.data(), cosRef.data(), 0, VERIFY_SIZE);
+        g_RoundMode = ROUND_TO_NEAREST;
+        failed += (bad != 0);
+        total += bad;
+    }
+    printf("%-12s %s, %ld mismatches\n", "fp16SinCosN", failed ? "FAILED" : "ok", total);
+
+    failed += VerifyUnary("fp16SinN", fp16SinN, hf_sin, LibmSin, true);
+    failed += VerifyUnary("fp16CosN", fp16CosN, hf_cos, LibmCos, false);
+    return failed;
+}
+
+/********************************************************************************************/
+/*                                  fp16_t -> integer                                       */
+/********************************************************************************************/
+/**
+ *@ingroup verify static method
+ *@brief   VerifyCompare of integer results
+ *@return  Return count of mismatches
+ */
+template <typename T> static long VerifyCompareInt(const char *what, const T *got, const T *ref, uint32_t first, uint32_t end){
+    long bad = 0;
+    for (uint32_t i = first; i < end; i++){
+        if (got[i] != ref[i]){
+            if (bad < 4){
+                printf("    %s: input 0x%04x got %lld expected %lld\n", what, i, (long long)got[i], (long long)ref[i]);
+            }
+            bad++;
+        }
+    }
+    return bad;
+}
+
+static int32_t Fp16ToInt32ByMode(const uint16_t &h){
+    return fp16ToInt32(h, g_RoundMode);
+}
+
+/**
+ *@ingroup verify static method
+ *@param [in] h           uint16_t value of fp16_t
+ *@param [in] roundMode   round mode
+ *@param [in] scalarFunc  scalar method of T under g_RoundMode
+ *@brief   Reference of fp16ToInt8N ~ fp16ToUInt32N: scalarFunc under ROUND_TO_NEAREST and
+ *         ROUND_BY_TRUNCATED, fp16ToInt32 saturated to T under the directed modes
+ *@return  Return reference result
+ */
+template <typename T> static T VerifyIntReference(uint16_t h, fp16RoundMode_t roundMode, T (*scalarFunc)(const uint16_t &)){
+    if (roundMode == ROUND_TO_NEAREST || roundMode == ROUND_BY_TRUNCATED){
+        g_RoundMode = roundMode;
+        T ret = scalarFunc(h);
+        g_RoundMode = ROUND_TO_NEAREST;
+        return ret;
+    }
+    if (FP16_IS_INF(h)){
+        return FP16_EXTRAC_SIGN(h) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    }
+    int64_t v = fp16ToInt32(h, roundMode);
+    v = std::min<int64_t>(std::max<int64_t>(v, std::numeric_limits<T>::min()), std::numeric_limits<T>::max());
+    return (T)v;
+}
+
+/**
+ *@ingroup verify static method
+ *@param [in] name        printed name
+ *@param [in] arrayFunc   array kernel
+ *@param [in] scalarFunc  see VerifyIntReference
+ *@brief   Check arrayFunc over all inputs at every SIMD level and round mode, whole array and
+ *         an unaligned odd length slice for the tails. Denormals round under the directed
+ *         modes, 0x0001/0x8001 are checked apart so they are named in the output
+ *@return  Return count of failed checks
+ */
+template <typename T> static int VerifyToInt(const char *name, void (*arrayFunc)(const uint16_t *, T *, size_t, fp16RoundMode_t),
+                                             T (*scalarFunc)(const uint16_t &)){
+    std::vector<uint16_t> src(VERIFY_SIZE);
+    std::vector<T> dst(VERIFY_SIZE), ref(VERIFY_SIZE);
+    for (uint32_t i = 0; i < VERIFY_SIZE; i++){
+        src[i] = (uint16_t)i;
+    }
+    int failed = 0;
+    long total = 0;
+    char what[96];
+    for (int mode = ROUND_TO_NEAREST; mode < ROUND_MODE_RESERVED; mode++){
+        fp16RoundMode_t roundMode = (fp16RoundMode_t)mode;
+        for (uint32_t i = 0; i < VERIFY_SIZE; i++){
+            ref[i] = VerifyIntReference<T>((uint16_t)i, roundMode, scalarFunc);
+        }
+        //smallest denormals: ceiling of +min and floor of -min are not zero for signed T
+        long bad = 0;
+        T expectPos = (roundMode == ROUND_TO_CEILING) ? 1 : 0;
+        T expectNeg = (roundMode == ROUND_TO_FLOOR && std::numeric_limits<T>::is_signed) ? (T)-1 : 0;
+        if (ref[0x0001] != expectPos || ref[0x8001] != expectNeg){
+            printf("    %s reference, %s: denormals give %lld/%lld\n", name, g_ModeNames[mode],
+                   (long long)ref[0x0001], (long long)ref[0x8001]);
+            bad++;
+        }
+        for (int level = SIMD_LEVEL_SCALAR; level < SIMD_LEVEL_RESERVED; level++){
+            SetFp16SimdLevel((fp16SimdLevel_t)level);
+            if (GetFp16SimdLevel() != level){
+                break;
+            }
+            snprintf(what, sizeof(what), "%s %s, %s", name, g_LevelNames[level], g_ModeNames[mode]);
+            arrayFunc(src.data(), dst.data(), VERIFY_SIZE, roundMode);
+            long levelBad = VerifyCompareInt(what, dst.data(), ref.data(), 0, VERIFY_SIZE);
+            dst.assign(VERIFY_SIZE, 0);
+            arrayFunc(src.data() + 1, dst.data() + 1, VERIFY_SIZE - 4, roundMode);
+            levelBad += VerifyCompareInt(what, dst.data(), ref.data(), 1, VERIFY_SIZE - 3);
+            failed += (levelBad != 0);
+            total += levelBad;
+        }
+        SetFp16SimdLevel(SIMD_LEVEL_RESERVED);
+        failed += (bad != 0);
+        total += bad;
+    }
+    printf("%-12s %s, %ld mismatches\n", name, failed ? "FAILED" : "ok", total);
+    return failed;
+}
+
+static int VerifyInt(){
+    int failed = 0;
+    failed += VerifyToInt<int8_t>("fp16ToInt8N", fp16ToInt8N, fp16ToInt8);
+    failed += VerifyToInt<uint8_t>("fp16ToUInt8N", fp16ToUInt8N, fp16ToUInt8);
+    failed += VerifyToInt<int16_t>("fp16ToInt16N", fp16ToInt16N, fp16ToInt16);
+    failed += VerifyToInt<uint16_t>("fp16ToUInt16N", fp16ToUInt16N, fp16ToUInt16);
+    failed += VerifyToInt<int32_t>("fp16ToInt32N", fp16ToInt32N, Fp16ToInt32ByMode);
+    failed += VerifyToInt<uint32_t>("fp16ToUInt32N", fp16ToUInt32N, fp16ToUInt32);
+    return failed;
+}
+
+int main(){
+    int failed = 0;
+    failed += VerifyExpLog();
+    failed += VerifySinCos();
+    failed += VerifyInt();
+    return failed;
+}
+
+/***compile command, run from the directory of this file:*********************************************************/
+/***g++ -std=c++11 -O2 -Ifp16 Verify.cpp fp16/fp16_t.cc fp16/fp16div.cc fp16/fp16_table.cc fp16/fp16_array.cc             */
+/***    fp16/fp16_simd.cc fp16/fp16_math.cc -o verify*********************************************************************/
+/***the same with -DFP16_NO_MATH_TABLE checks the table-free scalar methods:                                          */
+/***g++ -std=c++11 -O2 -DFP16_NO_MATH_TABLE -Ifp16 Verify.cpp fp16/fp16_t.cc fp16/fp16div.cc fp16/fp16_table.cc         */
+/***    fp16/fp16_array.cc fp16/fp16_simd.cc fp16/fp16_math.cc -o verify_notable******************************************/
+/*********************************************************************************************************************/
@@ -0,0 +1,2424 @@
+/**
+ * @file fp16_array.cc
+ *
+ * Copyright(C), 2017 - 2018, Lxzh Tech. Co., Ltd. ALL RIGHTS RESERVED.
+ *
+ * @brief array methods of Half precision float
+ *
+ * @version 1.0
+ *
+ */
+#include "fp16_array.h"
+#include "fpe.h"
+#include <limits>
+#include <string.h>
+
+/**
+ *@ingroup fp16_array basic parameter
+ *@brief   exponent difference between fp32 and fp16 placed at fp32 exponent field
+ */
+#define FP16_TO_FP32_EXP_REBIAS        ((uint32_t)(FP32_EXP_BIAS - FP16_EXP_BIAS) << FP32_MAN_LEN)
+
+/*********************************fp16_t -> float*********************************/
+static void Fp16ToFloatScalar(const uint16_t *src, float *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        dst[i] = fp16ToFloat(src[i]);
+    }
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_array static method
+ *@param [in] h four fp16_t values zero extended to 32 bits
+ *@brief   Convert fp16_t to float/fp32 the same way as fp16ToFloat: normal numbers
+ *         and exponent 31 are rebiased, denormals are scaled by 2^-24
+ *@return  Return four float/fp32 values
+ */
+FP16_TARGET_SSE2 static inline __m128 Fp16x4ToFloatSSE2(__m128i h){
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sign = _mm_slli_epi32(_mm_srli_epi32(h, FP16_SIGN_INDEX), FP32_SIGN_INDEX);
+    __m128i mag = _mm_and_si128(h, _mm_set1_epi32(FP16_ABS_MAX));
+    __m128i normal = _mm_add_epi32(_mm_slli_epi32(mag, FP32_MAN_LEN - FP16_MAN_LEN),
+                                   _mm_set1_epi32(FP16_TO_FP32_EXP_REBIAS));
+    //denormal mantissa is exact in float, m*2^-24 is its value
+    __m128 denorm = _mm_mul_ps(_mm_cvtepi32_ps(mag), _mm_set1_ps(1.0f / (1 << 24)));
+    __m128i isDenorm = _mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(FP16_EXP_MASK)), zero);
+    __m128i ret = _mm_or_si128(_mm_and_si128(isDenorm, _mm_castps_si128(denorm)),
+                               _mm_andnot_si128(isDenorm, normal));
+    return _mm_castsi128_ps(_mm_or_si128(ret, sign));
+}
+
+FP16_TARGET_SSE2 static void Fp16ToFloatSSE2(const uint16_t *src, float *dst, size_t n){
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        __m128i h = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_ps(dst + i, Fp16x4ToFloatSSE2(_mm_unpacklo_epi16(h, zero)));
+        _mm_storeu_ps(dst + i + 4, Fp16x4ToFloatSSE2(_mm_unpackhi_epi16(h, zero)));
+    }
+    Fp16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] h eight fp16_t values
+ *@brief   Convert fp16_t to float/fp32 by F16C, lanes of exponent 31 are patched since
+ *         fp16ToFloat rebiases them to finite values instead of returning inf/NaN
+ *@return  Return eight float/fp32 values
+ */
+FP16_TARGET_AVX2 static inline __m256 Fp16x8ToFloatAVX2(__m128i h){
+    const __m256i expMask = _mm256_set1_epi32(FP16_EXP_MASK);
+    __m256 ret = _mm256_cvtph_ps(h);
+    __m256i w = _mm256_cvtepu16_epi32(h);
+    __m256i isMaxExp = _mm256_cmpeq_epi32(_mm256_and_si256(w, expMask), expMask);
+    if (!_mm256_testz_si256(isMaxExp, isMaxExp)){
+        __m256i sign = _mm256_slli_epi32(_mm256_srli_epi32(w, FP16_SIGN_INDEX), FP32_SIGN_INDEX);
+        __m256i mag = _mm256_and_si256(w, _mm256_set1_epi32(FP16_ABS_MAX));
+        __m256i bits = _mm256_add_epi32(_mm256_slli_epi32(mag, FP32_MAN_LEN - FP16_MAN_LEN),
+                                        _mm256_set1_epi32(FP16_TO_FP32_EXP_REBIAS));
+        bits = _mm256_or_si256(bits, sign);
+        ret = _mm256_blendv_ps(ret, _mm256_castsi256_ps(bits), _mm256_castsi256_ps(isMaxExp));
+    }
+    return ret;
+}
+
+FP16_TARGET_AVX2 static void Fp16ToFloatAVX2(const uint16_t *src, float *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m128i h0 = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i h1 = _mm_loadu_si128((const __m128i *)(src + i + 8));
+        _mm256_storeu_ps(dst + i, Fp16x8ToFloatAVX2(h0));
+        _mm256_storeu_ps(dst + i + 8, Fp16x8ToFloatAVX2(h1));
+    }
+    for (; i + 8 <= n; i += 8){
+        _mm256_storeu_ps(dst + i, Fp16x8ToFloatAVX2(_mm_loadu_si128((const __m128i *)(src + i))));
+    }
+    Fp16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+FP16_AVX512_BEGIN
+FP16_TARGET_AVX512 static inline __m512 Fp16x16ToFloatAVX512(__m256i h){
+    const __m512i expMask = _mm512_set1_epi32(FP16_EXP_MASK);
+    __m512 ret = _mm512_cvtph_ps(h);
+    __m512i w = _mm512_cvtepu16_epi32(h);
+    __mmask16 isMaxExp = _mm512_cmpeq_epi32_mask(_mm512_and_si512(w, expMask), expMask);
+    if (isMaxExp){
+        __m512i sign = _mm512_slli_epi32(_mm512_srli_epi32(w, FP16_SIGN_INDEX), FP32_SIGN_INDEX);
+        __m512i mag = _mm512_and_si512(w, _mm512_set1_epi32(FP16_ABS_MAX));
+        __m512i bits = _mm512_add_epi32(_mm512_slli_epi32(mag, FP32_MAN_LEN - FP16_MAN_LEN),
+                                        _mm512_set1_epi32(FP16_TO_FP32_EXP_REBIAS));
+        bits = _mm512_or_si512(bits, sign);
+        ret = _mm512_mask_mov_ps(ret, isMaxExp, _mm512_castsi512_ps(bits));
+    }
+    return ret;
+}
+
+FP16_TARGET_AVX512 static void Fp16ToFloatAVX512(const uint16_t *src, float *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m256i h = _mm256_loadu_si256((const __m256i *)(src + i));
+        _mm512_storeu_ps(dst + i, Fp16x16ToFloatAVX512(h));
+    }
+    if (i < n){
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        __m256i h = _mm256_maskz_loadu_epi16(tail, src + i);
+        _mm512_mask_storeu_ps(dst + i, tail, Fp16x16ToFloatAVX512(h));
+    }
+}
+FP16_AVX512_END
+#endif
+
+void fp16ToFloatN(const uint16_t *src, float *dst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        Fp16ToFloatAVX512(src, dst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        Fp16ToFloatAVX2(src, dst, n);
+        return;
+    case SIMD_LEVEL_SSE2:
+        Fp16ToFloatSSE2(src, dst, n);
+        return;
+#endif
+    default:
+        Fp16ToFloatScalar(src, dst, n);
+        return;
+    }
+}
+
+/*********************************float -> fp16_t*********************************/
+/**
+ *@ingroup fp16_array static method
+ *@param [in] sign   sign of the orginal value
+ *@param [in] lsb    last preserved bit
+ *@param [in] guard  highest truncated bit
+ *@param [in] sticky whether the truncated bits below guard are not zero
+ *@brief   judge whether to add one to the truncated result under roundMode
+ *@return  Return 1 if add one, otherwise 0
+ */
+template <fp16RoundMode_t roundMode> static inline uint32_t RoundIncrement(uint32_t sign, uint32_t lsb, uint32_t guard, uint32_t sticky){
+    switch (roundMode){
+    case ROUND_TO_NEAREST:
+        return guard & (sticky | lsb);
+    case ROUND_TO_CEILING:
+        return (sign ^ 1) & (guard | sticky);
+    case ROUND_TO_FLOOR:
+        return sign & (guard | sticky);
+    default:
+        return 0;
+    }
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_array static method
+ *@brief   AVX2 lane version of RoundIncrement, every input lane is 0 or 1 except
+ *         lsb whose bit0 is used
+ *@return  Return 1 in lanes to add one, otherwise 0
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static inline __m256i RoundIncrementAVX2(__m256i sign, __m256i lsb, __m256i guard, __m256i sticky){
+    switch (roundMode){
+    case ROUND_TO_NEAREST:
+        return _mm256_and_si256(guard, _mm256_or_si256(sticky, _mm256_and_si256(lsb, _mm256_set1_epi32(1))));
+    case ROUND_TO_CEILING:
+        return _mm256_andnot_si256(sign, _mm256_or_si256(guard, sticky));
+    case ROUND_TO_FLOOR:
+        return _mm256_and_si256(sign, _mm256_or_si256(guard, sticky));
+    default:
+        return _mm256_setzero_si256();
+    }
+}
+
+FP16_AVX512_BEGIN
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static inline __m512i RoundIncrementAVX512(__m512i sign, __m512i lsb, __m512i guard, __m512i sticky){
+    switch (roundMode){
+    case ROUND_TO_NEAREST:
+        return _mm512_and_si512(guard, _mm512_or_si512(sticky, _mm512_and_si512(lsb, _mm512_set1_epi32(1))));
+    case ROUND_TO_CEILING:
+        return _mm512_andnot_si512(sign, _mm512_or_si512(guard, sticky));
+    case ROUND_TO_FLOOR:
+        return _mm512_and_si512(sign, _mm512_or_si512(guard, sticky));
+    default:
+        return _mm512_setzero_si512();
+    }
+}
+FP16_AVX512_END
+#endif
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] ui32 bits of a float/fp32 value
+ *@brief   Convert float/fp32 to fp16_t with the same ranges as fp16_t::operator=(const float&):
+ *         e>143 saturates, 112<e<=143 is normal, 102<=e<=112 is denormal, smaller ones
+ *         only keep a sticky bit
+ *@return  Return uint16_t value of fp16_t
+ */
+template <fp16RoundMode_t roundMode> static uint16_t FloatToFp16(uint32_t ui32){
+    uint32_t s_ret = ui32 >> FP32_SIGN_INDEX;
+    uint32_t abs_v = ui32 & FP32_ABS_MAX;
+    uint32_t e_f = abs_v >> FP32_MAN_LEN;
+    uint32_t m_ret, guard, sticky;
+    uint16_t ret;
+
+    if (e_f > 0x8Fu){//0x8Fu:143=127+16
+        return (uint16_t)((s_ret << FP16_SIGN_INDEX) | FP16_MAX);
+    }
+    else if (e_f > 0x70u){//exponent and mantissa are rounded together, carry goes to exponent
+        m_ret = (abs_v >> (FP32_MAN_LEN - FP16_MAN_LEN)) - (0x70u << FP16_MAN_LEN);
+        guard = (abs_v >> 12) & 1;
+        sticky = (abs_v & 0xFFFu) != 0;
+        m_ret += RoundIncrement<roundMode>(s_ret, m_ret & 1, guard, sticky);
+        ret = (uint16_t)std::min(m_ret, (uint32_t)FP16_MAX);
+    }
+    else{//denormal, a carry into bit10 gives the minimum normal value
+        uint32_t m_f = abs_v & FP32_MAN_MASK;
+        if (e_f){
+            m_f |= FP32_MAN_HIDE_BIT;
+        }
+        uint32_t shift_out = 0x7Eu - e_f;//0x7E:126=102+24, 14 bits for e=112
+        if (shift_out > 25){
+            m_ret = 0;
+            guard = 0;
+            sticky = (m_f != 0);
+        }
+        else{
+            m_ret = m_f >> shift_out;
+            guard = (m_f >> (shift_out - 1)) & 1;
+            sticky = (m_f & ((1u << (shift_out - 1)) - 1)) != 0;
+        }
+        m_ret += RoundIncrement<roundMode>(s_ret, m_ret & 1, guard, sticky);
+        ret = (uint16_t)m_ret;
+    }
+    return (uint16_t)((s_ret << FP16_SIGN_INDEX) | ret);
+}
+
+template <fp16RoundMode_t roundMode> static void FloatToFp16Scalar(const float *src, uint16_t *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        uint32_t ui32;
+        memcpy(&ui32, src + i, sizeof(ui32));
+        dst[i] = FloatToFp16<roundMode>(ui32);
+    }
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_array static method
+ *@brief   AVX2 lane version of FloatToFp16: both the normal and the denormal candidate
+ *         are computed and selected by exponent, variable shifts of 32 or more give zero
+ *@return  Return eight fp16_t values in the low 16 bits of each lane
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static inline __m256i FloatToFp16x8AVX2(__m256i u){
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sign = _mm256_srli_epi32(u, FP32_SIGN_INDEX);
+    __m256i absV = _mm256_and_si256(u, _mm256_set1_epi32(FP32_ABS_MAX));
+    __m256i e = _mm256_srli_epi32(absV, FP32_MAN_LEN);
+    __m256i isNormal = _mm256_cmpgt_epi32(e, _mm256_set1_epi32(0x70));
+
+    //normal: e>112
+    __m256i qN = _mm256_sub_epi32(_mm256_srli_epi32(absV, FP32_MAN_LEN - FP16_MAN_LEN), _mm256_set1_epi32(0x70 << FP16_MAN_LEN));
+    __m256i gN = _mm256_and_si256(_mm256_srli_epi32(absV, 12), one);
+    __m256i stN = _mm256_and_si256(absV, _mm256_set1_epi32(0xFFF));
+
+    //denormal: e<=112
+    __m256i m = _mm256_and_si256(absV, _mm256_set1_epi32(FP32_MAN_MASK));
+    __m256i hide = _mm256_andnot_si256(_mm256_cmpeq_epi32(e, zero), _mm256_set1_epi32(FP32_MAN_HIDE_BIT));
+    m = _mm256_or_si256(m, hide);
+    __m256i shift = _mm256_sub_epi32(_mm256_set1_epi32(0x7E), e);
+    __m256i shiftG = _mm256_sub_epi32(shift, one);
+    __m256i qD = _mm256_srlv_epi32(m, shift);
+    __m256i gD = _mm256_and_si256(_mm256_srlv_epi32(m, shiftG), one);
+    __m256i stD = _mm256_and_si256(m, _mm256_sub_epi32(_mm256_sllv_epi32(one, shiftG), one));
+
+    __m256i q = _mm256_blendv_epi8(qD, qN, isNormal);
+    __m256i g = _mm256_blendv_epi8(gD, gN, isNormal);
+    __m256i st = _mm256_blendv_epi8(stD, stN, isNormal);
+    st = _mm256_andnot_si256(_mm256_cmpeq_epi32(st, zero), one);
+
+    q = _mm256_add_epi32(q, RoundIncrementAVX2<roundMode>(sign, q, g, st));
+
+    //exponent 31 or beyond saturates, denormal can not reach it
+    q = _mm256_min_epi32(q, _mm256_set1_epi32(FP16_MAX));
+    return _mm256_or_si256(q, _mm256_slli_epi32(sign, FP16_SIGN_INDEX));
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static void FloatToFp16AVX2(const float *src, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m256i lo = FloatToFp16x8AVX2<roundMode>(_mm256_loadu_si256((const __m256i *)(src + i)));
+        __m256i hi = FloatToFp16x8AVX2<roundMode>(_mm256_loadu_si256((const __m256i *)(src + i + 8)));
+        __m256i h = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256((__m256i *)(dst + i), h);
+    }
+    FloatToFp16Scalar<roundMode>(src + i, dst + i, n - i);
+}
+
+FP16_AVX512_BEGIN
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static inline __m256i FloatToFp16x16AVX512(__m512i u){
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i sign = _mm512_srli_epi32(u, FP32_SIGN_INDEX);
+    __m512i absV = _mm512_and_si512(u, _mm512_set1_epi32(FP32_ABS_MAX));
+    __m512i e = _mm512_srli_epi32(absV, FP32_MAN_LEN);
+    __mmask16 isNormal = _mm512_cmpgt_epi32_mask(e, _mm512_set1_epi32(0x70));
+
+    //denormal: e<=112
+    __m512i m = _mm512_and_si512(absV, _mm512_set1_epi32(FP32_MAN_MASK));
+    m = _mm512_mask_or_epi32(m, _mm512_cmpneq_epi32_mask(e, zero), m, _mm512_set1_epi32(FP32_MAN_HIDE_BIT));
+    __m512i shift = _mm512_sub_epi32(_mm512_set1_epi32(0x7E), e);
+    __m512i shiftG = _mm512_sub_epi32(shift, one);
+    __m512i q = _mm512_srlv_epi32(m, shift);
+    __m512i g = _mm512_and_si512(_mm512_srlv_epi32(m, shiftG), one);
+    __m512i st = _mm512_and_si512(m, _mm512_sub_epi32(_mm512_sllv_epi32(one, shiftG), one));
+
+    //normal: e>112
+    q = _mm512_mask_sub_epi32(q, isNormal, _mm512_srli_epi32(absV, FP32_MAN_LEN - FP16_MAN_LEN), _mm512_set1_epi32(0x70 << FP16_MAN_LEN));
+    g = _mm512_mask_and_epi32(g, isNormal, _mm512_srli_epi32(absV, 12), one);
+    st = _mm512_mask_and_epi32(st, isNormal, absV, _mm512_set1_epi32(0xFFF));
+    st = _mm512_maskz_mov_epi32(_mm512_test_epi32_mask(st, st), one);
+
+    q = _mm512_add_epi32(q, RoundIncrementAVX512<roundMode>(sign, q, g, st));
+
+    //exponent 31 or beyond saturates, denormal can not reach it
+    q = _mm512_min_epi32(q, _mm512_set1_epi32(FP16_MAX));
+    q = _mm512_or_si512(q, _mm512_slli_epi32(sign, FP16_SIGN_INDEX));
+    return _mm512_cvtepi32_epi16(q);
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static void FloatToFp16AVX512(const float *src, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m512i u = _mm512_loadu_si512((const void *)(src + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), FloatToFp16x16AVX512<roundMode>(u));
+    }
+    if (i < n){
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        __m512i u = _mm512_maskz_loadu_epi32(tail, src + i);
+        _mm256_mask_storeu_epi16(dst + i, tail, FloatToFp16x16AVX512<roundMode>(u));
+    }
+}
+FP16_AVX512_END
+#endif
+
+template <fp16RoundMode_t roundMode> static void FloatToFp16Dispatch(const float *src, uint16_t *dst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        FloatToFp16AVX512<roundMode>(src, dst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        FloatToFp16AVX2<roundMode>(src, dst, n);
+        return;
+#endif
+    default://SSE2 has no variable shift, use scalar path
+        FloatToFp16Scalar<roundMode>(src, dst, n);
+        return;
+    }
+}
+
+void floatToFp16N(const float *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    switch (roundMode){
+    case ROUND_TO_CEILING:
+        FloatToFp16Dispatch<ROUND_TO_CEILING>(src, dst, n);
+        break;
+    case ROUND_TO_FLOOR:
+        FloatToFp16Dispatch<ROUND_TO_FLOOR>(src, dst, n);
+        break;
+    case ROUND_BY_TRUNCATED:
+        FloatToFp16Dispatch<ROUND_BY_TRUNCATED>(src, dst, n);
+        break;
+    default:
+        FloatToFp16Dispatch<ROUND_TO_NEAREST>(src, dst, n);
+        break;
+    }
+}
+
+/*********************************fp16_t <-> double*********************************/
+static void Fp16ToDoubleScalar(const uint16_t *src, double *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        dst[i] = fp16ToDouble(src[i]);
+    }
+}
+
+#ifdef FP16_SIMD_X86
+//every fp16_t value is exact in float, widening float to double is exact as well
+FP16_TARGET_SSE2 static void Fp16ToDoubleSSE2(const uint16_t *src, double *dst, size_t n){
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        __m128i h = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128 lo = Fp16x4ToFloatSSE2(_mm_unpacklo_epi16(h, zero));
+        __m128 hi = Fp16x4ToFloatSSE2(_mm_unpackhi_epi16(h, zero));
+        _mm_storeu_pd(dst + i, _mm_cvtps_pd(lo));
+        _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(lo, lo)));
+        _mm_storeu_pd(dst + i + 4, _mm_cvtps_pd(hi));
+        _mm_storeu_pd(dst + i + 6, _mm_cvtps_pd(_mm_movehl_ps(hi, hi)));
+    }
+    Fp16ToDoubleScalar(src + i, dst + i, n - i);
+}
+
+FP16_TARGET_AVX2 static void Fp16ToDoubleAVX2(const uint16_t *src, double *dst, size_t n){
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        __m256 f = Fp16x8ToFloatAVX2(_mm_loadu_si128((const __m128i *)(src + i)));
+        _mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+        _mm256_storeu_pd(dst + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+    }
+    Fp16ToDoubleScalar(src + i, dst + i, n - i);
+}
+
+FP16_AVX512_BEGIN
+FP16_TARGET_AVX512 static inline void StoreDoubleX16AVX512(double *dst, __mmask16 mask, __m512 f){
+    __m256 hi = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(f), 1));
+    _mm512_mask_storeu_pd(dst, (__mmask8)mask, _mm512_cvtps_pd(_mm512_castps512_ps256(f)));
+    _mm512_mask_storeu_pd(dst + 8, (__mmask8)(mask >> 8), _mm512_cvtps_pd(hi));
+}
+
+FP16_TARGET_AVX512 static void Fp16ToDoubleAVX512(const uint16_t *src, double *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m256i h = _mm256_loadu_si256((const __m256i *)(src + i));
+        StoreDoubleX16AVX512(dst + i, 0xFFFF, Fp16x16ToFloatAVX512(h));
+    }
+    if (i < n){
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        __m256i h = _mm256_maskz_loadu_epi16(tail, src + i);
+        StoreDoubleX16AVX512(dst + i, tail, Fp16x16ToFloatAVX512(h));
+    }
+}
+FP16_AVX512_END
+#endif
+
+void fp16ToDoubleN(const uint16_t *src, double *dst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        Fp16ToDoubleAVX512(src, dst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        Fp16ToDoubleAVX2(src, dst, n);
+        return;
+    case SIMD_LEVEL_SSE2:
+        Fp16ToDoubleSSE2(src, dst, n);
+        return;
+#endif
+    default:
+        Fp16ToDoubleScalar(src, dst, n);
+        return;
+    }
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] ui64 bits of a double/fp64 value
+ *@brief   Convert double/fp64 to fp16_t with one rounding: the fp16_t lsb is bit 42 of the
+ *         mantissa for e>=1009 and 2^-24 below, so exponent and mantissa are rounded together
+ *         and a carry goes to the exponent or from denormal to normal; e>=1040 gives an
+ *         exponent of 31 or more which saturates like fp16_t::operator=(const double&)
+ *@return  Return uint16_t value of fp16_t
+ */
+template <fp16RoundMode_t roundMode> static uint16_t DoubleToFp16(uint64_t ui64){
+    uint32_t s_ret = (uint32_t)(ui64 >> FP64_SIGN_INDEX);
+    uint64_t e_d = (ui64 & FP64_EXP_MASK) >> FP64_MAN_LEN;
+    uint64_t m_d = ui64 & FP64_MAN_MASK;
+    if (e_d){
+        m_d |= FP64_MAN_HIDE_BIT;
+    }
+    //0x41B:1051=1009+42, a shift of 63 leaves only sticky bits of a 53 bits mantissa
+    uint32_t shift_out = (uint32_t)std::min(std::max((int64_t)0x41B - (int64_t)e_d, (int64_t)42), (int64_t)63);
+    uint64_t e_part = (e_d > 0x3F1u) ? ((e_d - 0x3F1u) << FP16_MAN_LEN) : 0;
+    uint64_t m_ret = e_part + (m_d >> shift_out);
+    uint32_t guard = (uint32_t)(m_d >> (shift_out - 1)) & 1;
+    uint32_t sticky = (m_d & ((1llu << (shift_out - 1)) - 1)) != 0;
+    m_ret += RoundIncrement<roundMode>(s_ret, (uint32_t)m_ret & 1, guard, sticky);
+    m_ret = std::min(m_ret, (uint64_t)FP16_MAX);
+    return (uint16_t)((s_ret << FP16_SIGN_INDEX) | (uint32_t)m_ret);
+}
+
+template <fp16RoundMode_t roundMode> static void DoubleToFp16Scalar(const double *src, uint16_t *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        uint64_t ui64;
+        memcpy(&ui64, src + i, sizeof(ui64));
+        dst[i] = DoubleToFp16<roundMode>(ui64);
+    }
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_array static method
+ *@brief   AVX2 lane version of DoubleToFp16, AVX2 has no 64 bits min/max so clamps are
+ *         done by compare and blend
+ *@return  Return four fp16_t values in the low 16 bits of each 64 bits lane
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static inline __m256i DoubleToFp16x4AVX2(__m256i u){
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sign = _mm256_srli_epi64(u, FP64_SIGN_INDEX);
+    __m256i e = _mm256_srli_epi64(_mm256_and_si256(u, _mm256_set1_epi64x(FP64_EXP_MASK)), FP64_MAN_LEN);
+    __m256i m = _mm256_and_si256(u, _mm256_set1_epi64x(FP64_MAN_MASK));
+    __m256i hide = _mm256_andnot_si256(_mm256_cmpeq_epi64(e, zero), _mm256_set1_epi64x(FP64_MAN_HIDE_BIT));
+    m = _mm256_or_si256(m, hide);
+
+    __m256i shift = _mm256_sub_epi64(_mm256_set1_epi64x(0x41B), e);
+    shift = _mm256_blendv_epi8(shift, _mm256_set1_epi64x(42), _mm256_cmpgt_epi64(_mm256_set1_epi64x(42), shift));
+    shift = _mm256_blendv_epi8(shift, _mm256_set1_epi64x(63), _mm256_cmpgt_epi64(shift, _mm256_set1_epi64x(63)));
+    __m256i shiftG = _mm256_sub_epi64(shift, one);
+    __m256i ePart = _mm256_sub_epi64(e, _mm256_set1_epi64x(0x3F1));
+    ePart = _mm256_and_si256(_mm256_slli_epi64(ePart, FP16_MAN_LEN), _mm256_cmpgt_epi64(ePart, zero));
+
+    __m256i q = _mm256_add_epi64(ePart, _mm256_srlv_epi64(m, shift));
+    __m256i g = _mm256_and_si256(_mm256_srlv_epi64(m, shiftG), one);
+    __m256i st = _mm256_and_si256(m, _mm256_sub_epi64(_mm256_sllv_epi64(one, shiftG), one));
+    st = _mm256_andnot_si256(_mm256_cmpeq_epi64(st, zero), one);
+
+    q = _mm256_add_epi64(q, RoundIncrementAVX2<roundMode>(sign, q, g, st));
+    q = _mm256_blendv_epi8(q, _mm256_set1_epi64x(FP16_MAX), _mm256_cmpgt_epi64(q, _mm256_set1_epi64x(FP16_MAX)));
+    return _mm256_or_si256(q, _mm256_slli_epi64(sign, FP16_SIGN_INDEX));
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static void DoubleToFp16AVX2(const double *src, uint16_t *dst, size_t n){
+    const __m256i order = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        __m256i lo = DoubleToFp16x4AVX2<roundMode>(_mm256_loadu_si256((const __m256i *)(src + i)));
+        __m256i hi = DoubleToFp16x4AVX2<roundMode>(_mm256_loadu_si256((const __m256i *)(src + i + 4)));
+        //32 bits lanes are lo0 lo1 hi0 hi1 | lo2 lo3 hi2 hi3 after packing
+        __m256i w = _mm256_permutevar8x32_epi32(_mm256_packus_epi32(lo, hi), order);
+        __m128i h = _mm_packus_epi32(_mm256_castsi256_si128(w), _mm256_extracti128_si256(w, 1));
+        _mm_storeu_si128((__m128i *)(dst + i), h);
+    }
+    DoubleToFp16Scalar<roundMode>(src + i, dst + i, n - i);
+}
+
+FP16_AVX512_BEGIN
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static inline __m128i DoubleToFp16x8AVX512(__m512i u){
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i sign = _mm512_srli_epi64(u, FP64_SIGN_INDEX);
+    __m512i e = _mm512_srli_epi64(_mm512_and_si512(u, _mm512_set1_epi64(FP64_EXP_MASK)), FP64_MAN_LEN);
+    __m512i m = _mm512_and_si512(u, _mm512_set1_epi64(FP64_MAN_MASK));
+    m = _mm512_mask_or_epi64(m, _mm512_cmpneq_epi64_mask(e, zero), m, _mm512_set1_epi64(FP64_MAN_HIDE_BIT));
+
+    __m512i shift = _mm512_sub_epi64(_mm512_set1_epi64(0x41B), e);
+    shift = _mm512_min_epi64(_mm512_max_epi64(shift, _mm512_set1_epi64(42)), _mm512_set1_epi64(63));
+    __m512i shiftG = _mm512_sub_epi64(shift, one);
+    __m512i ePart = _mm512_max_epi64(_mm512_sub_epi64(e, _mm512_set1_epi64(0x3F1)), zero);
+
+    __m512i q = _mm512_add_epi64(_mm512_slli_epi64(ePart, FP16_MAN_LEN), _mm512_srlv_epi64(m, shift));
+    __m512i g = _mm512_and_si512(_mm512_srlv_epi64(m, shiftG), one);
+    __m512i st = _mm512_and_si512(m, _mm512_sub_epi64(_mm512_sllv_epi64(one, shiftG), one));
+    st = _mm512_maskz_mov_epi64(_mm512_test_epi64_mask(st, st), one);
+
+    q = _mm512_add_epi64(q, RoundIncrementAVX512<roundMode>(sign, q, g, st));
+    q = _mm512_min_epi64(q, _mm512_set1_epi64(FP16_MAX));
+    q = _mm512_or_si512(q, _mm512_slli_epi64(sign, FP16_SIGN_INDEX));
+    return _mm512_cvtepi64_epi16(q);
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static void DoubleToFp16AVX512(const double *src, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        __m512i u = _mm512_loadu_si512((const void *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), DoubleToFp16x8AVX512<roundMode>(u));
+    }
+    if (i < n){
+        __mmask8 tail = (__mmask8)((1u << (n - i)) - 1);
+        __m512i u = _mm512_maskz_loadu_epi64(tail, src + i);
+        _mm_mask_storeu_epi16(dst + i, tail, DoubleToFp16x8AVX512<roundMode>(u));
+    }
+}
+FP16_AVX512_END
+#endif
+
+template <fp16RoundMode_t roundMode> static void DoubleToFp16Dispatch(const double *src, uint16_t *dst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        DoubleToFp16AVX512<roundMode>(src, dst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        DoubleToFp16AVX2<roundMode>(src, dst, n);
+        return;
+#endif
+    default://SSE2 has no 64 bits compare or variable shift, use scalar path
+        DoubleToFp16Scalar<roundMode>(src, dst, n);
+        return;
+    }
+}
+
+void doubleToFp16N(const double *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    switch (roundMode){
+    case ROUND_TO_CEILING:
+        DoubleToFp16Dispatch<ROUND_TO_CEILING>(src, dst, n);
+        break;
+    case ROUND_TO_FLOOR:
+        DoubleToFp16Dispatch<ROUND_TO_FLOOR>(src, dst, n);
+        break;
+    case ROUND_BY_TRUNCATED:
+        DoubleToFp16Dispatch<ROUND_BY_TRUNCATED>(src, dst, n);
+        break;
+    default:
+        DoubleToFp16Dispatch<ROUND_TO_NEAREST>(src, dst, n);
+        break;
+    }
+}
+
+/*********************************fp16_t -> integer*********************************/
+/**
+ *@ingroup fp16_array static method
+ *@brief   fp16ToInt8 ~ fp16ToUInt32 except fp16ToInt32 return zero for denormals, the
+ *         directed modes follow fp16ToInt32 and round denormals as any other value
+ *@return  Return true if denormals of T convert to zero under roundMode
+ */
+template <fp16RoundMode_t roundMode, typename T> static inline bool Fp16ToIntDenormZero(){
+    const bool isInt32 = std::numeric_limits<T>::is_signed && (sizeof(T) == sizeof(int32_t));
+    return !isInt32 && (ROUND_TO_NEAREST == roundMode || ROUND_BY_TRUNCATED == roundMode);
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] h uint16_t value of fp16_t
+ *@brief   Convert fp16_t to integer type T as fp16ToInt8 ~ fp16ToUInt32 do: inf saturates,
+ *         exponent 31 is finite, negative values are zero for unsigned types, denormals
+ *         are zero under ROUND_TO_NEAREST and ROUND_BY_TRUNCATED except for int32_t, other
+ *         values and denormals of the directed modes are rounded by roundMode as
+ *         fp16ToInt32 does and saturate
+ *@return  Return integer result
+ */
+template <fp16RoundMode_t roundMode, typename T> static T Fp16ToInt(uint16_t h){
+    const bool isSigned = std::numeric_limits<T>::is_signed;
+    const bool denormZero = Fp16ToIntDenormZero<roundMode, T>();
+    uint32_t s = FP16_EXTRAC_SIGN(h);
+    uint32_t e = FP16_EXTRAC_EXP(h);
+    uint32_t m = FP16_EXTRAC_MAN(h);
+    if ((e == 0 && denormZero) || (!isSigned && s)){
+        return 0;
+    }
+    if (FP16_IS_INF(h)){
+        return s ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    }
+    //m*2^(e-25), the value of a denormal int32_t is m*2^-25 as fp16ToInt32 takes it
+    uint32_t left = (e > 25) ? e - 25 : 0;
+    uint32_t right = (e < 25) ? 25 - e : 0;
+    uint32_t q = (m << left) >> right;
+    uint32_t frac = right ? (m << (32 - right)) : 0;
+    q += RoundIncrement<roundMode>(s, q, frac >> 31, (frac << 1) != 0);
+    int64_t v = s ? -(int64_t)q : (int64_t)q;
+    v = std::min<int64_t>(std::max<int64_t>(v, std::numeric_limits<T>::min()), std::numeric_limits<T>::max());
+    return (T)v;
+}
+
+template <fp16RoundMode_t roundMode, typename T> static void Fp16ToIntScalar(const uint16_t *src, T *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        dst[i] = Fp16ToInt<roundMode, T>(src[i]);
+    }
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_array static method
+ *@brief   AVX2 lane version of Fp16ToInt before saturation: signed results are in int32_t
+ *         with inf as INT32 max/min, unsigned ones are already limited to the max of T
+ *@return  Return eight int32_t/uint32_t values
+ */
+template <fp16RoundMode_t roundMode, typename T> FP16_TARGET_AVX2 static inline __m256i Fp16ToIntX8AVX2(__m128i h){
+    const bool isSigned = std::numeric_limits<T>::is_signed;
+    const bool denormZero = Fp16ToIntDenormZero<roundMode, T>();
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i x = _mm256_cvtepu16_epi32(h);
+    __m256i s = _mm256_srli_epi32(x, FP16_SIGN_INDEX);
+    __m256i e = _mm256_and_si256(_mm256_srli_epi32(x, FP16_MAN_LEN), _mm256_set1_epi32(FP16_MAX_EXP));
+    __m256i denorm = _mm256_cmpeq_epi32(e, zero);
+    __m256i m = _mm256_or_si256(_mm256_and_si256(x, _mm256_set1_epi32(FP16_MAN_MASK)),
+                                _mm256_andnot_si256(denorm, _mm256_set1_epi32(FP16_MAN_HIDE_BIT)));
+    __m256i left = _mm256_max_epi32(_mm256_sub_epi32(e, _mm256_set1_epi32(25)), zero);
+    __m256i right = _mm256_max_epi32(_mm256_sub_epi32(_mm256_set1_epi32(25), e), zero);
+    __m256i q = _mm256_srlv_epi32(_mm256_sllv_epi32(m, left), right);
+    __m256i frac = _mm256_sllv_epi32(m, _mm256_sub_epi32(_mm256_set1_epi32(32), right));//shift of 32 gives zero
+    __m256i sticky = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_slli_epi32(frac, 1), zero), one);
+    q = _mm256_add_epi32(q, RoundIncrementAVX2<roundMode>(s, q, _mm256_srli_epi32(frac, 31), sticky));
+
+    __m256i inf = _mm256_cmpeq_epi32(_mm256_and_si256(x, _mm256_set1_epi32(FP16_ABS_MAX)), _mm256_set1_epi32(FP16_ABS_MAX));
+    __m256i neg = _mm256_sub_epi32(zero, s);
+    __m256i r;
+    if (isSigned){
+        r = _mm256_add_epi32(_mm256_xor_si256(q, neg), s);
+        r = _mm256_blendv_epi8(r, _mm256_add_epi32(_mm256_set1_epi32(INT32_T_MAX), s), inf);
+    }
+    else{
+        const __m256i maxV = _mm256_set1_epi32((int)std::numeric_limits<T>::max());
+        r = _mm256_blendv_epi8(_mm256_min_epu32(q, maxV), maxV, inf);
+        r = _mm256_andnot_si256(neg, r);
+    }
+    if (denormZero){
+        r = _mm256_andnot_si256(denorm, r);
+    }
+    return r;
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@brief   Saturate and store sixteen results of Fp16ToIntX8AVX2
+ */
+template <typename T> FP16_TARGET_AVX2 static inline void StoreIntX16AVX2(T *dst, __m256i lo, __m256i hi){
+    const bool isSigned = std::numeric_limits<T>::is_signed;
+    if (sizeof(T) == sizeof(int32_t)){
+        _mm256_storeu_si256((__m256i *)dst, lo);
+        _mm256_storeu_si256((__m256i *)(dst + 8), hi);
+        return;
+    }
+    __m256i h = isSigned ? _mm256_packs_epi32(lo, hi) : _mm256_packus_epi32(lo, hi);
+    h = _mm256_permute4x64_epi64(h, 0xD8);
+    if (sizeof(T) == sizeof(int16_t)){
+        _mm256_storeu_si256((__m256i *)dst, h);
+        return;
+    }
+    __m128i h0 = _mm256_castsi256_si128(h);
+    __m128i h1 = _mm256_extracti128_si256(h, 1);
+    _mm_storeu_si128((__m128i *)dst, isSigned ? _mm_packs_epi16(h0, h1) : _mm_packus_epi16(h0, h1));
+}
+
+template <fp16RoundMode_t roundMode, typename T> FP16_TARGET_AVX2 static void Fp16ToIntAVX2(const uint16_t *src, T *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m256i lo = Fp16ToIntX8AVX2<roundMode, T>(_mm_loadu_si128((const __m128i *)(src + i)));
+        __m256i hi = Fp16ToIntX8AVX2<roundMode, T>(_mm_loadu_si128((const __m128i *)(src + i + 8)));
+        StoreIntX16AVX2(dst + i, lo, hi);
+    }
+    Fp16ToIntScalar<roundMode, T>(src + i, dst + i, n - i);
+}
+
+FP16_AVX512_BEGIN
+/**
+ *@ingroup fp16_array static method
+ *@brief   AVX-512 lane version of Fp16ToIntX8AVX2
+ *@return  Return sixteen int32_t/uint32_t values
+ */
+template <fp16RoundMode_t roundMode, typename T> FP16_TARGET_AVX512 static inline __m512i Fp16ToIntX16AVX512(__m256i h){
+    const bool isSigned = std::numeric_limits<T>::is_signed;
+    const bool denormZero = Fp16ToIntDenormZero<roundMode, T>();
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi32(1);
+    __m512i x = _mm512_cvtepu16_epi32(h);
+    __m512i s = _mm512_srli_epi32(x, FP16_SIGN_INDEX);
+    __m512i e = _mm512_and_si512(_mm512_srli_epi32(x, FP16_MAN_LEN), _mm512_set1_epi32(FP16_MAX_EXP));
+    __mmask16 normal = _mm512_test_epi32_mask(e, e);
+    __m512i m = _mm512_and_si512(x, _mm512_set1_epi32(FP16_MAN_MASK));
+    m = _mm512_mask_or_epi32(m, normal, m, _mm512_set1_epi32(FP16_MAN_HIDE_BIT));
+    __m512i left = _mm512_max_epi32(_mm512_sub_epi32(e, _mm512_set1_epi32(25)), zero);
+    __m512i right = _mm512_max_epi32(_mm512_sub_epi32(_mm512_set1_epi32(25), e), zero);
+    __m512i q = _mm512_srlv_epi32(_mm512_sllv_epi32(m, left), right);
+    __m512i frac = _mm512_sllv_epi32(m, _mm512_sub_epi32(_mm512_set1_epi32(32), right));
+    __m512i sticky = _mm512_maskz_mov_epi32(_mm512_test_epi32_mask(frac, _mm512_set1_epi32(0x7FFFFFFF)), one);
+    q = _mm512_add_epi32(q, RoundIncrementAVX512<roundMode>(s, q, _mm512_srli_epi32(frac, 31), sticky));
+
+    __mmask16 inf = _mm512_cmpeq_epi32_mask(_mm512_and_si512(x, _mm512_set1_epi32(FP16_ABS_MAX)), _mm512_set1_epi32(FP16_ABS_MAX));
+    __mmask16 neg = _mm512_test_epi32_mask(s, s);
+    __m512i r;
+    if (isSigned){
+        r = _mm512_mask_sub_epi32(q, neg, zero, q);
+        r = _mm512_mask_add_epi32(r, inf, _mm512_set1_epi32(INT32_T_MAX), s);
+    }
+    else{
+        const __m512i maxV = _mm512_set1_epi32((int)std::numeric_limits<T>::max());
+        r = _mm512_mask_mov_epi32(_mm512_min_epu32(q, maxV), inf, maxV);
+        r = _mm512_mask_mov_epi32(r, neg, zero);
+    }
+    if (denormZero){
+        r = _mm512_maskz_mov_epi32(normal, r);
+    }
+    return r;
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] mask lanes to be stored
+ *@brief   Saturate and store results of Fp16ToIntX16AVX512
+ */
+template <typename T> FP16_TARGET_AVX512 static inline void StoreIntX16AVX512(T *dst, __mmask16 mask, __m512i r){
+    const bool isSigned = std::numeric_limits<T>::is_signed;
+    switch (sizeof(T)){
+    case sizeof(int8_t):
+        if (isSigned){
+            _mm512_mask_cvtsepi32_storeu_epi8(dst, mask, r);
+        }
+        else{
+            _mm512_mask_cvtusepi32_storeu_epi8(dst, mask, r);
+        }
+        return;
+    case sizeof(int16_t):
+        if (isSigned){
+            _mm512_mask_cvtsepi32_storeu_epi16(dst, mask, r);
+        }
+        else{
+            _mm512_mask_cvtusepi32_storeu_epi16(dst, mask, r);
+        }
+        return;
+    default:
+        _mm512_mask_storeu_epi32(dst, mask, r);
+        return;
+    }
+}
+
+template <fp16RoundMode_t roundMode, typename T> FP16_TARGET_AVX512 static void Fp16ToIntAVX512(const uint16_t *src, T *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m256i h = _mm256_loadu_si256((const __m256i *)(src + i));
+        StoreIntX16AVX512(dst + i, (__mmask16)0xFFFF, Fp16ToIntX16AVX512<roundMode, T>(h));
+    }
+    if (i < n){
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        __m256i h = _mm256_maskz_loadu_epi16(tail, src + i);
+        StoreIntX16AVX512(dst + i, tail, Fp16ToIntX16AVX512<roundMode, T>(h));
+    }
+}
+FP16_AVX512_END
+#endif
+
+template <fp16RoundMode_t roundMode, typename T> static void Fp16ToIntDispatch(const uint16_t *src, T *dst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        Fp16ToIntAVX512<roundMode, T>(src, dst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        Fp16ToIntAVX2<roundMode, T>(src, dst, n);
+        return;
+#endif
+    default://SSE2 has no variable shift, use scalar path
+        Fp16ToIntScalar<roundMode, T>(src, dst, n);
+        return;
+    }
+}
+
+template <typename T> static void Fp16ToIntByMode(const uint16_t *src, T *dst, size_t n, fp16RoundMode_t roundMode){
+    switch (roundMode){
+    case ROUND_TO_CEILING:
+        Fp16ToIntDispatch<ROUND_TO_CEILING, T>(src, dst, n);
+        break;
+    case ROUND_TO_FLOOR:
+        Fp16ToIntDispatch<ROUND_TO_FLOOR, T>(src, dst, n);
+        break;
+    case ROUND_BY_TRUNCATED:
+        Fp16ToIntDispatch<ROUND_BY_TRUNCATED, T>(src, dst, n);
+        break;
+    default:
+        Fp16ToIntDispatch<ROUND_TO_NEAREST, T>(src, dst, n);
+        break;
+    }
+}
+
+void fp16ToInt8N(const uint16_t *src, int8_t *dst, size_t n, fp16RoundMode_t roundMode){
+    Fp16ToIntByMode(src, dst, n, roundMode);
+}
+
+void fp16ToUInt8N(const uint16_t *src, uint8_t *dst, size_t n, fp16RoundMode_t roundMode){
+    Fp16ToIntByMode(src, dst, n, roundMode);
+}
+
+void fp16ToInt16N(const uint16_t *src, int16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    Fp16ToIntByMode(src, dst, n, roundMode);
+}
+
+void fp16ToUInt16N(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    Fp16ToIntByMode(src, dst, n, roundMode);
+}
+
+void fp16ToInt32N(const uint16_t *src, int32_t *dst, size_t n, fp16RoundMode_t roundMode){
+    Fp16ToIntByMode(src, dst, n, roundMode);
+}
+
+void fp16ToUInt32N(const uint16_t *src, uint32_t *dst, size_t n, fp16RoundMode_t roundMode){
+    Fp16ToIntByMode(src, dst, n, roundMode);
+}
+
+/*********************************integer -> fp16_t*********************************/
+/**
+ *@ingroup fp16_array static method
+ *@param [in] v integer value
+ *@brief   Convert integer type T to fp16_t as fp16_t::operator= does: the magnitude is
+ *         rounded by roundMode to 11 bits, int32_t/uint32_t saturate to FP16_MAX and
+ *         uint16_t rounds to exponent 31 above 65519, -128 of int8_t is -0
+ *@return  Return uint16_t value of fp16_t
+ */
+template <fp16RoundMode_t roundMode, typename T> static uint16_t IntToFp16(T v){
+    const bool isSigned = std::numeric_limits<T>::is_signed;
+    uint32_t s = (isSigned && v < 0) ? 1 : 0;
+    uint32_t u = s ? 0u - (uint32_t)v : (uint32_t)v;
+    if (sizeof(T) == sizeof(int8_t) && isSigned){
+        u &= INT8_T_MAX;
+    }
+    uint32_t h = 0;
+    if (u){
+        int len = 32 - Clz32(u);
+        int sh = len - (FP16_MAN_LEN + 1);
+        uint32_t q = (sh <= 0) ? (u << -sh) : (u >> sh);
+        if (sh > 0){
+            uint32_t frac = u << (32 - sh);
+            q += RoundIncrement<roundMode>(s, q, frac >> 31, (frac << 1) != 0);
+        }
+        h = ((uint32_t)(FP16_EXP_BIAS - 2 + len) << FP16_MAN_LEN) + q;//the hidden bit adds one to exponent
+        if (sizeof(T) == sizeof(int32_t)){
+            h = std::min(h, (uint32_t)FP16_MAX);
+        }
+    }
+    return (uint16_t)((s << FP16_SIGN_INDEX) | h);
+}
+
+template <fp16RoundMode_t roundMode, typename T> static void IntToFp16Scalar(const T *src, uint16_t *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        dst[i] = IntToFp16<roundMode, T>(src[i]);
+    }
+}
+
+#ifdef FP16_SIMD_X86
+template <typename T> FP16_TARGET_AVX2 static inline __m256i LoadIntX8AVX2(const T *src){
+    const bool isSigned = std::numeric_limits<T>::is_signed;
+    switch (sizeof(T)){
+    case sizeof(int8_t):
+        {
+            __m128i v = _mm_loadl_epi64((const __m128i *)src);
+            return isSigned ? _mm256_cvtepi8_epi32(v) : _mm256_cvtepu8_epi32(v);
+        }
+    case sizeof(int16_t):
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)src);
+            return isSigned ? _mm256_cvtepi16_epi32(v) : _mm256_cvtepu16_epi32(v);
+        }
+    default:
+        return _mm256_loadu_si256((const __m256i *)src);
+    }
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] v eight integers of type T in int32_t lanes
+ *@brief   AVX2 lane version of IntToFp16, the bit length comes from the float exponent of
+ *         the isolated leading one, variable shifts of 32 or more give zero
+ *@return  Return eight fp16_t values in the low 16 bits of each lane
+ */
+template <fp16RoundMode_t roundMode, typename T> FP16_TARGET_AVX2 static inline __m256i IntToFp16X8AVX2(__m256i v){
+    const bool isSigned = std::numeric_limits<T>::is_signed;
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i s = isSigned ? _mm256_srli_epi32(v, 31) : zero;
+    __m256i u = isSigned ? _mm256_abs_epi32(v) : v;
+    if (sizeof(T) == sizeof(int8_t) && isSigned){
+        u = _mm256_and_si256(u, _mm256_set1_epi32(INT8_T_MAX));
+    }
+    __m256i lead = _mm256_andnot_si256(_mm256_srli_epi32(u, 1), u);
+    __m256i len = _mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(lead)), FP32_MAN_LEN),
+                                   _mm256_set1_epi32(FP32_EXP_BIAS - 1));
+    if (sizeof(T) == sizeof(int32_t)){//bit 31 converts as a negative float
+        len = _mm256_blendv_epi8(len, _mm256_set1_epi32(32), _mm256_srai_epi32(u, 31));
+    }
+    __m256i sh = _mm256_sub_epi32(len, _mm256_set1_epi32(FP16_MAN_LEN + 1));
+    __m256i q = _mm256_or_si256(_mm256_sllv_epi32(u, _mm256_sub_epi32(zero, sh)), _mm256_srlv_epi32(u, sh));
+    __m256i frac = _mm256_sllv_epi32(u, _mm256_sub_epi32(_mm256_set1_epi32(32), sh));
+    __m256i sticky = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_slli_epi32(frac, 1), zero), _mm256_set1_epi32(1));
+    q = _mm256_add_epi32(q, RoundIncrementAVX2<roundMode>(s, q, _mm256_srli_epi32(frac, 31), sticky));
+    __m256i h = _mm256_add_epi32(_mm256_slli_epi32(_mm256_add_epi32(len, _mm256_set1_epi32(FP16_EXP_BIAS - 2)), FP16_MAN_LEN), q);
+    if (sizeof(T) == sizeof(int32_t)){
+        h = _mm256_min_epi32(h, _mm256_set1_epi32(FP16_MAX));
+    }
+    h = _mm256_andnot_si256(_mm256_cmpeq_epi32(u, zero), h);
+    return _mm256_or_si256(h, _mm256_slli_epi32(s, FP16_SIGN_INDEX));
+}
+
+template <fp16RoundMode_t roundMode, typename T> FP16_TARGET_AVX2 static void IntToFp16AVX2(const T *src, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m256i lo = IntToFp16X8AVX2<roundMode, T>(LoadIntX8AVX2(src + i));
+        __m256i hi = IntToFp16X8AVX2<roundMode, T>(LoadIntX8AVX2(src + i + 8));
+        __m256i h = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256((__m256i *)(dst + i), h);
+    }
+    IntToFp16Scalar<roundMode, T>(src + i, dst + i, n - i);
+}
+
+FP16_AVX512_BEGIN
+/**
+ *@ingroup fp16_array static method
+ *@param [in] mask lanes to be loaded, others are zero
+ */
+template <typename T> FP16_TARGET_AVX512 static inline __m512i LoadIntX16AVX512(const T *src, __mmask16 mask){
+    const bool isSigned = std::numeric_limits<T>::is_signed;
+    switch (sizeof(T)){
+    case sizeof(int8_t):
+        {
+            __m128i v = _mm_maskz_loadu_epi8(mask, src);
+            return isSigned ? _mm512_cvtepi8_epi32(v) : _mm512_cvtepu8_epi32(v);
+        }
+    case sizeof(int16_t):
+        {
+            __m256i v = _mm256_maskz_loadu_epi16(mask, src);
+            return isSigned ? _mm512_cvtepi16_epi32(v) : _mm512_cvtepu16_epi32(v);
+        }
+    default:
+        return _mm512_maskz_loadu_epi32(mask, src);
+    }
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@brief   AVX-512 lane version of IntToFp16X8AVX2
+ *@return  Return sixteen fp16_t values
+ */
+template <fp16RoundMode_t roundMode, typename T> FP16_TARGET_AVX512 static inline __m256i IntToFp16X16AVX512(__m512i v){
+    const bool isSigned = std::numeric_limits<T>::is_signed;
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i s = isSigned ? _mm512_srli_epi32(v, 31) : zero;
+    __m512i u = isSigned ? _mm512_abs_epi32(v) : v;
+    if (sizeof(T) == sizeof(int8_t) && isSigned){
+        u = _mm512_and_si512(u, _mm512_set1_epi32(INT8_T_MAX));
+    }
+    __m512i lead = _mm512_andnot_si512(_mm512_srli_epi32(u, 1), u);
+    __m512i len = _mm512_sub_epi32(_mm512_srli_epi32(_mm512_castps_si512(_mm512_cvtepu32_ps(lead)), FP32_MAN_LEN),
+                                   _mm512_set1_epi32(FP32_EXP_BIAS - 1));
+    __m512i sh = _mm512_sub_epi32(len, _mm512_set1_epi32(FP16_MAN_LEN + 1));
+    __m512i q = _mm512_or_si512(_mm512_sllv_epi32(u, _mm512_sub_epi32(zero, sh)), _mm512_srlv_epi32(u, sh));
+    __m512i frac = _mm512_sllv_epi32(u, _mm512_sub_epi32(_mm512_set1_epi32(32), sh));
+    __m512i sticky = _mm512_maskz_mov_epi32(_mm512_test_epi32_mask(frac, _mm512_set1_epi32(0x7FFFFFFF)), _mm512_set1_epi32(1));
+    q = _mm512_add_epi32(q, RoundIncrementAVX512<roundMode>(s, q, _mm512_srli_epi32(frac, 31), sticky));
+    __m512i h = _mm512_add_epi32(_mm512_slli_epi32(_mm512_add_epi32(len, _mm512_set1_epi32(FP16_EXP_BIAS - 2)), FP16_MAN_LEN), q);
+    if (sizeof(T) == sizeof(int32_t)){
+        h = _mm512_min_epi32(h, _mm512_set1_epi32(FP16_MAX));
+    }
+    h = _mm512_maskz_mov_epi32(_mm512_test_epi32_mask(u, u), h);
+    return _mm512_cvtepi32_epi16(_mm512_or_si512(h, _mm512_slli_epi32(s, FP16_SIGN_INDEX)));
+}
+
+template <fp16RoundMode_t roundMode, typename T> FP16_TARGET_AVX512 static void IntToFp16AVX512(const T *src, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m512i v = LoadIntX16AVX512(src + i, (__mmask16)0xFFFF);
+        _mm256_storeu_si256((__m256i *)(dst + i), IntToFp16X16AVX512<roundMode, T>(v));
+    }
+    if (i < n){
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        __m512i v = LoadIntX16AVX512(src + i, tail);
+        _mm256_mask_storeu_epi16(dst + i, tail, IntToFp16X16AVX512<roundMode, T>(v));
+    }
+}
+FP16_AVX512_END
+#endif
+
+template <fp16RoundMode_t roundMode, typename T> static void IntToFp16Dispatch(const T *src, uint16_t *dst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        IntToFp16AVX512<roundMode, T>(src, dst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        IntToFp16AVX2<roundMode, T>(src, dst, n);
+        return;
+#endif
+    default://SSE2 has no variable shift, use scalar path
+        IntToFp16Scalar<roundMode, T>(src, dst, n);
+        return;
+    }
+}
+
+template <typename T> static void IntToFp16ByMode(const T *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    switch (roundMode){
+    case ROUND_TO_CEILING:
+        IntToFp16Dispatch<ROUND_TO_CEILING, T>(src, dst, n);
+        break;
+    case ROUND_TO_FLOOR:
+        IntToFp16Dispatch<ROUND_TO_FLOOR, T>(src, dst, n);
+        break;
+    case ROUND_BY_TRUNCATED:
+        IntToFp16Dispatch<ROUND_BY_TRUNCATED, T>(src, dst, n);
+        break;
+    default:
+        IntToFp16Dispatch<ROUND_TO_NEAREST, T>(src, dst, n);
+        break;
+    }
+}
+
+void int8ToFp16N(const int8_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    IntToFp16ByMode(src, dst, n, roundMode);
+}
+
+void uint8ToFp16N(const uint8_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    IntToFp16ByMode(src, dst, n, roundMode);
+}
+
+void int16ToFp16N(const int16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    IntToFp16ByMode(src, dst, n, roundMode);
+}
+
+void uint16ToFp16N(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    IntToFp16ByMode(src, dst, n, roundMode);
+}
+
+void int32ToFp16N(const int32_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    IntToFp16ByMode(src, dst, n, roundMode);
+}
+
+void uint32ToFp16N(const uint32_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    IntToFp16ByMode(src, dst, n, roundMode);
+}
+
+/*********************************fp16_t +-* fp16_t*********************************/
+template <fp16RoundMode_t roundMode> static void Fp16AddScalar(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        dst[i] = fp16Add<roundMode>(src1[i], src2[i]);
+    }
+}
+
+template <fp16RoundMode_t roundMode> static void Fp16SubScalar(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        dst[i] = fp16Sub<roundMode>(src1[i], src2[i]);
+    }
+}
+
+template <fp16RoundMode_t roundMode> static void Fp16MulScalar(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        dst[i] = fp16Mul<roundMode>(src1[i], src2[i]);
+    }
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_array static method
+ *@param [in] a eight fp16_t values
+ *@param [in] b eight fp16_t values
+ *@brief   Add fp16_t by float: the float sum s is rounded once more to fp16_t, so the
+ *         exact error of s by two-sum is folded into its last bit first. A float
+ *         mantissa which is a tie or exact for fp16_t is even, so an even s moves one
+ *         ulp towards the exact sum and an odd s is already inexact on the right side
+ *@return  Return eight fp16_t values in the low 16 bits of each lane
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static inline __m256i Fp16AddX8AVX2(__m128i a, __m128i b){
+    __m256 fa = Fp16x8ToFloatAVX2(a);
+    __m256 fb = Fp16x8ToFloatAVX2(b);
+    __m256 s = _mm256_add_ps(fa, fb);
+    __m256 bv = _mm256_sub_ps(s, fa);
+    __m256 av = _mm256_sub_ps(s, bv);
+    __m256 err = _mm256_add_ps(_mm256_sub_ps(fa, av), _mm256_sub_ps(fb, bv));
+
+    __m256i u = _mm256_castps_si256(s);
+    __m256i ue = _mm256_castps_si256(err);
+    __m256i inexact = _mm256_cmpgt_epi32(_mm256_and_si256(ue, _mm256_set1_epi32(FP32_ABS_MAX)), _mm256_setzero_si256());
+    __m256i even = _mm256_cmpeq_epi32(_mm256_and_si256(u, _mm256_set1_epi32(1)), _mm256_setzero_si256());
+    __m256i step = _mm256_or_si256(_mm256_srai_epi32(_mm256_xor_si256(u, ue), 31), _mm256_set1_epi32(1));//+1 or -1
+    u = _mm256_add_epi32(u, _mm256_and_si256(_mm256_and_si256(inexact, even), step));
+    return FloatToFp16x8AVX2<roundMode>(u);
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@brief   Multiply fp16_t by float, the product of two 11 bits mantissas is exact
+ *@return  Return eight fp16_t values in the low 16 bits of each lane
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static inline __m256i Fp16MulX8AVX2(__m128i a, __m128i b){
+    __m256 p = _mm256_mul_ps(Fp16x8ToFloatAVX2(a), Fp16x8ToFloatAVX2(b));
+    return FloatToFp16x8AVX2<roundMode>(_mm256_castps_si256(p));
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] negate 0x8000 to subtract src2, 0 to add it
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static void Fp16AddAVX2(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, uint16_t negate){
+    const __m128i neg = _mm_set1_epi16((short)negate);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m128i a0 = _mm_loadu_si128((const __m128i *)(src1 + i));
+        __m128i a1 = _mm_loadu_si128((const __m128i *)(src1 + i + 8));
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(src2 + i)), neg);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(src2 + i + 8)), neg);
+        __m256i lo = Fp16AddX8AVX2<roundMode>(a0, b0);
+        __m256i hi = Fp16AddX8AVX2<roundMode>(a1, b1);
+        __m256i h = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256((__m256i *)(dst + i), h);
+    }
+    if (negate){
+        Fp16SubScalar<roundMode>(src1 + i, src2 + i, dst + i, n - i);
+    }
+    else{
+        Fp16AddScalar<roundMode>(src1 + i, src2 + i, dst + i, n - i);
+    }
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static void Fp16MulAVX2(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m128i a0 = _mm_loadu_si128((const __m128i *)(src1 + i));
+        __m128i a1 = _mm_loadu_si128((const __m128i *)(src1 + i + 8));
+        __m128i b0 = _mm_loadu_si128((const __m128i *)(src2 + i));
+        __m128i b1 = _mm_loadu_si128((const __m128i *)(src2 + i + 8));
+        __m256i lo = Fp16MulX8AVX2<roundMode>(a0, b0);
+        __m256i hi = Fp16MulX8AVX2<roundMode>(a1, b1);
+        __m256i h = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256((__m256i *)(dst + i), h);
+    }
+    Fp16MulScalar<roundMode>(src1 + i, src2 + i, dst + i, n - i);
+}
+
+FP16_AVX512_BEGIN
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static inline __m256i Fp16AddX16AVX512(__m256i a, __m256i b){
+    __m512 fa = Fp16x16ToFloatAVX512(a);
+    __m512 fb = Fp16x16ToFloatAVX512(b);
+    __m512 s = _mm512_add_ps(fa, fb);
+    __m512 bv = _mm512_sub_ps(s, fa);
+    __m512 av = _mm512_sub_ps(s, bv);
+    __m512 err = _mm512_add_ps(_mm512_sub_ps(fa, av), _mm512_sub_ps(fb, bv));
+
+    __m512i u = _mm512_castps_si512(s);
+    __m512i ue = _mm512_castps_si512(err);
+    __mmask16 fold = _mm512_test_epi32_mask(ue, _mm512_set1_epi32(FP32_ABS_MAX)) &
+                     _mm512_testn_epi32_mask(u, _mm512_set1_epi32(1));
+    __m512i step = _mm512_or_si512(_mm512_srai_epi32(_mm512_xor_si512(u, ue), 31), _mm512_set1_epi32(1));//+1 or -1
+    u = _mm512_mask_add_epi32(u, fold, u, step);
+    return FloatToFp16x16AVX512<roundMode>(u);
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static inline __m256i Fp16MulX16AVX512(__m256i a, __m256i b){
+    __m512 p = _mm512_mul_ps(Fp16x16ToFloatAVX512(a), Fp16x16ToFloatAVX512(b));
+    return FloatToFp16x16AVX512<roundMode>(_mm512_castps_si512(p));
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static void Fp16AddAVX512(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, uint16_t negate){
+    const __m256i neg = _mm256_set1_epi16((short)negate);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src1 + i));
+        __m256i b = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(src2 + i)), neg);
+        _mm256_storeu_si256((__m256i *)(dst + i), Fp16AddX16AVX512<roundMode>(a, b));
+    }
+    if (i < n){
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        __m256i a = _mm256_maskz_loadu_epi16(tail, src1 + i);
+        __m256i b = _mm256_xor_si256(_mm256_maskz_loadu_epi16(tail, src2 + i), neg);
+        _mm256_mask_storeu_epi16(dst + i, tail, Fp16AddX16AVX512<roundMode>(a, b));
+    }
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static void Fp16MulAVX512(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src1 + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src2 + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), Fp16MulX16AVX512<roundMode>(a, b));
+    }
+    if (i < n){
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        __m256i a = _mm256_maskz_loadu_epi16(tail, src1 + i);
+        __m256i b = _mm256_maskz_loadu_epi16(tail, src2 + i);
+        _mm256_mask_storeu_epi16(dst + i, tail, Fp16MulX16AVX512<roundMode>(a, b));
+    }
+}
+FP16_AVX512_END
+#endif
+
+template <fp16RoundMode_t roundMode> static void Fp16AddDispatch(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, uint16_t negate){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        Fp16AddAVX512<roundMode>(src1, src2, dst, n, negate);
+        return;
+    case SIMD_LEVEL_AVX2:
+        Fp16AddAVX2<roundMode>(src1, src2, dst, n, negate);
+        return;
+#endif
+    default://SSE2 has no variable shift, use scalar path
+        if (negate){
+            Fp16SubScalar<roundMode>(src1, src2, dst, n);
+        }
+        else{
+            Fp16AddScalar<roundMode>(src1, src2, dst, n);
+        }
+        return;
+    }
+}
+
+template <fp16RoundMode_t roundMode> static void Fp16MulDispatch(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        Fp16MulAVX512<roundMode>(src1, src2, dst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        Fp16MulAVX2<roundMode>(src1, src2, dst, n);
+        return;
+#endif
+    default://SSE2 has no variable shift, use scalar path
+        Fp16MulScalar<roundMode>(src1, src2, dst, n);
+        return;
+    }
+}
+
+static void Fp16AddByMode(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, fp16RoundMode_t roundMode, uint16_t negate){
+    switch (roundMode){
+    case ROUND_TO_CEILING:
+        Fp16AddDispatch<ROUND_TO_CEILING>(src1, src2, dst, n, negate);
+        break;
+    case ROUND_TO_FLOOR:
+        Fp16AddDispatch<ROUND_TO_FLOOR>(src1, src2, dst, n, negate);
+        break;
+    case ROUND_BY_TRUNCATED:
+        Fp16AddDispatch<ROUND_BY_TRUNCATED>(src1, src2, dst, n, negate);
+        break;
+    default:
+        Fp16AddDispatch<ROUND_TO_NEAREST>(src1, src2, dst, n, negate);
+        break;
+    }
+}
+
+void fp16AddN(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    Fp16AddByMode(src1, src2, dst, n, roundMode, 0);
+}
+
+void fp16SubN(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    Fp16AddByMode(src1, src2, dst, n, roundMode, FP16_SIGN_MASK);
+}
+
+void fp16MulN(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    switch (roundMode){
+    case ROUND_TO_CEILING:
+        Fp16MulDispatch<ROUND_TO_CEILING>(src1, src2, dst, n);
+        break;
+    case ROUND_TO_FLOOR:
+        Fp16MulDispatch<ROUND_TO_FLOOR>(src1, src2, dst, n);
+        break;
+    case ROUND_BY_TRUNCATED:
+        Fp16MulDispatch<ROUND_BY_TRUNCATED>(src1, src2, dst, n);
+        break;
+    default:
+        Fp16MulDispatch<ROUND_TO_NEAREST>(src1, src2, dst, n);
+        break;
+    }
+}
+
+/*********************************fp16_t / fp16_t*********************************/
+static void Fp16DivScalar(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    int flags = 0;
+    for (size_t i = 0; i < n; i++){
+        dst[i] = fp16_div(src1[i], src2[i], roundMode, &flags);
+    }
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_array static method
+ *@param [in]  h eight fp16_t values zero extended to 32 bits
+ *@param [out] m mantissa with the leading one moved to the hidden bit, zero stays zero
+ *@param [out] e exponent of the hidden bit
+ *@brief   AVX2 lane version of fp16_unpack and fp16_normalise, the leading one of a
+ *         denormal is found by the exponent of the mantissa converted to float
+ */
+FP16_TARGET_AVX2 static inline void Fp16UnpackAVX2(__m256i h, __m256i *m, __m256i *e){
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i exp = _mm256_and_si256(_mm256_srli_epi32(h, FP16_MAN_LEN), _mm256_set1_epi32(FP16_MAX_EXP));
+    __m256i man = _mm256_and_si256(h, _mm256_set1_epi32(FP16_MAX_MAN));
+    man = _mm256_or_si256(man, _mm256_andnot_si256(_mm256_cmpeq_epi32(exp, zero), _mm256_set1_epi32(FP16_MAN_HIDE_BIT)));
+    exp = _mm256_max_epi32(exp, _mm256_set1_epi32(1));
+    __m256i msb = _mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(man)), FP32_MAN_LEN),
+                                   _mm256_set1_epi32(FP32_EXP_BIAS));
+    __m256i shift = _mm256_sub_epi32(_mm256_set1_epi32(FP16_MAN_LEN), msb);
+    *m = _mm256_sllv_epi32(man, shift);
+    *e = _mm256_sub_epi32(exp, shift);
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@brief   AVX2 lane version of fp16_div: the float quotient of the mantissas is off by at
+ *         most one unit and is fixed by the integer remainder
+ *@return  Return eight fp16_t values in the low 16 bits of each lane
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static inline __m256i Fp16DivX8AVX2(__m256i a, __m256i b){
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sign = _mm256_srli_epi32(_mm256_xor_si256(a, b), FP16_SIGN_INDEX);
+    __m256i m_a, e_a, m_b, e_b;
+    Fp16UnpackAVX2(a, &m_a, &e_a);
+    Fp16UnpackAVX2(b, &m_b, &e_b);
+
+    //quotient is (2^13, 2^15), sticky bit at bit 0
+    __m256i num = _mm256_slli_epi32(m_a, 14);
+    __m256i q = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(num), _mm256_cvtepi32_ps(m_b)));
+    __m256i r = _mm256_sub_epi32(num, _mm256_mullo_epi32(q, m_b));
+    __m256i under = _mm256_cmpgt_epi32(zero, r);
+    q = _mm256_add_epi32(q, under);
+    r = _mm256_add_epi32(r, _mm256_and_si256(under, m_b));
+    __m256i over = _mm256_cmpgt_epi32(r, _mm256_sub_epi32(m_b, one));
+    q = _mm256_sub_epi32(q, over);
+    r = _mm256_sub_epi32(r, _mm256_and_si256(over, m_b));
+    __m256i x = _mm256_or_si256(q, _mm256_andnot_si256(_mm256_cmpeq_epi32(r, zero), one));
+
+    //leading one to bit 14
+    __m256i shift = _mm256_xor_si256(_mm256_srli_epi32(x, 14), one);
+    x = _mm256_sllv_epi32(x, shift);
+    __m256i e = _mm256_sub_epi32(_mm256_add_epi32(_mm256_sub_epi32(e_a, e_b), _mm256_set1_epi32(FP16_EXP_BIAS)), shift);
+
+    //denormal is shifted to exponent 1 with sticky, variable shifts of 32 or more give zero
+    __m256i d = _mm256_max_epi32(_mm256_sub_epi32(one, e), zero);
+    __m256i lost = _mm256_and_si256(x, _mm256_sub_epi32(_mm256_sllv_epi32(one, d), one));
+    x = _mm256_or_si256(_mm256_srlv_epi32(x, d), _mm256_andnot_si256(_mm256_cmpeq_epi32(lost, zero), one));
+    e = _mm256_max_epi32(e, one);
+
+    __m256i man = _mm256_srli_epi32(x, 4);
+    __m256i g = _mm256_and_si256(_mm256_srli_epi32(x, 3), one);
+    __m256i st = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_and_si256(x, _mm256_set1_epi32(7)), zero), one);
+    man = _mm256_add_epi32(man, RoundIncrementAVX2<roundMode>(sign, man, g, st));
+    __m256i carry = _mm256_srli_epi32(man, FP16_MAN_LEN + 1);
+    man = _mm256_srlv_epi32(man, carry);
+    e = _mm256_add_epi32(e, carry);
+    e = _mm256_and_si256(e, _mm256_cmpgt_epi32(man, _mm256_set1_epi32(FP16_MAX_MAN)));
+
+    //overflow and division by zero saturate, zero dividend gives +0
+    __m256i ret = _mm256_or_si256(_mm256_slli_epi32(e, FP16_MAN_LEN), _mm256_and_si256(man, _mm256_set1_epi32(FP16_MAX_MAN)));
+    __m256i isZeroB = _mm256_cmpeq_epi32(m_b, zero);
+    __m256i sat = _mm256_or_si256(_mm256_cmpgt_epi32(e, _mm256_set1_epi32(FP16_MAX_EXP - 1)), isZeroB);
+    ret = _mm256_blendv_epi8(ret, _mm256_set1_epi32(FP16_MAX), sat);
+    ret = _mm256_or_si256(ret, _mm256_slli_epi32(sign, FP16_SIGN_INDEX));
+    return _mm256_andnot_si256(_mm256_andnot_si256(isZeroB, _mm256_cmpeq_epi32(m_a, zero)), ret);
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static void Fp16DivAVX2(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m256i a0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src1 + i)));
+        __m256i a1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src1 + i + 8)));
+        __m256i b0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src2 + i)));
+        __m256i b1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src2 + i + 8)));
+        __m256i lo = Fp16DivX8AVX2<roundMode>(a0, b0);
+        __m256i hi = Fp16DivX8AVX2<roundMode>(a1, b1);
+        __m256i h = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256((__m256i *)(dst + i), h);
+    }
+    Fp16DivScalar(src1 + i, src2 + i, dst + i, n - i, roundMode);
+}
+
+FP16_AVX512_BEGIN
+FP16_TARGET_AVX512 static inline void Fp16UnpackAVX512(__m512i h, __m512i *m, __m512i *e){
+    __m512i exp = _mm512_and_si512(_mm512_srli_epi32(h, FP16_MAN_LEN), _mm512_set1_epi32(FP16_MAX_EXP));
+    __m512i man = _mm512_and_si512(h, _mm512_set1_epi32(FP16_MAX_MAN));
+    man = _mm512_mask_or_epi32(man, _mm512_test_epi32_mask(exp, exp), man, _mm512_set1_epi32(FP16_MAN_HIDE_BIT));
+    exp = _mm512_max_epi32(exp, _mm512_set1_epi32(1));
+    __m512i msb = _mm512_sub_epi32(_mm512_srli_epi32(_mm512_castps_si512(_mm512_cvtepi32_ps(man)), FP32_MAN_LEN),
+                                   _mm512_set1_epi32(FP32_EXP_BIAS));
+    __m512i shift = _mm512_sub_epi32(_mm512_set1_epi32(FP16_MAN_LEN), msb);
+    *m = _mm512_sllv_epi32(man, shift);
+    *e = _mm512_sub_epi32(exp, shift);
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static inline __m256i Fp16DivX16AVX512(__m512i a, __m512i b){
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i sign = _mm512_srli_epi32(_mm512_xor_si512(a, b), FP16_SIGN_INDEX);
+    __m512i m_a, e_a, m_b, e_b;
+    Fp16UnpackAVX512(a, &m_a, &e_a);
+    Fp16UnpackAVX512(b, &m_b, &e_b);
+
+    //quotient is (2^13, 2^15), sticky bit at bit 0
+    __m512i num = _mm512_slli_epi32(m_a, 14);
+    __m512i q = _mm512_cvttps_epi32(_mm512_div_ps(_mm512_cvtepi32_ps(num), _mm512_cvtepi32_ps(m_b)));
+    __m512i r = _mm512_sub_epi32(num, _mm512_mullo_epi32(q, m_b));
+    __mmask16 under = _mm512_cmplt_epi32_mask(r, zero);
+    q = _mm512_mask_sub_epi32(q, under, q, one);
+    r = _mm512_mask_add_epi32(r, under, r, m_b);
+    __mmask16 over = _mm512_cmpge_epi32_mask(r, m_b);
+    q = _mm512_mask_add_epi32(q, over, q, one);
+    r = _mm512_mask_sub_epi32(r, over, r, m_b);
+    __m512i x = _mm512_mask_or_epi32(q, _mm512_test_epi32_mask(r, r), q, one);
+
+    //leading one to bit 14
+    __m512i shift = _mm512_xor_si512(_mm512_srli_epi32(x, 14), one);
+    x = _mm512_sllv_epi32(x, shift);
+    __m512i e = _mm512_sub_epi32(_mm512_add_epi32(_mm512_sub_epi32(e_a, e_b), _mm512_set1_epi32(FP16_EXP_BIAS)), shift);
+
+    //denormal is shifted to exponent 1 with sticky, variable shifts of 32 or more give zero
+    __m512i d = _mm512_max_epi32(_mm512_sub_epi32(one, e), zero);
+    __m512i lost = _mm512_and_si512(x, _mm512_sub_epi32(_mm512_sllv_epi32(one, d), one));
+    x = _mm512_srlv_epi32(x, d);
+    x = _mm512_mask_or_epi32(x, _mm512_test_epi32_mask(lost, lost), x, one);
+    e = _mm512_max_epi32(e, one);
+
+    __m512i man = _mm512_srli_epi32(x, 4);
+    __m512i g = _mm512_and_si512(_mm512_srli_epi32(x, 3), one);
+    __m512i st = _mm512_maskz_mov_epi32(_mm512_test_epi32_mask(x, _mm512_set1_epi32(7)), one);
+    man = _mm512_add_epi32(man, RoundIncrementAVX512<roundMode>(sign, man, g, st));
+    __m512i carry = _mm512_srli_epi32(man, FP16_MAN_LEN + 1);
+    man = _mm512_srlv_epi32(man, carry);
+    e = _mm512_add_epi32(e, carry);
+    e = _mm512_maskz_mov_epi32(_mm512_cmpgt_epi32_mask(man, _mm512_set1_epi32(FP16_MAX_MAN)), e);
+
+    //overflow and division by zero saturate, zero dividend gives +0
+    __m512i ret = _mm512_or_si512(_mm512_slli_epi32(e, FP16_MAN_LEN), _mm512_and_si512(man, _mm512_set1_epi32(FP16_MAX_MAN)));
+    __mmask16 isZeroB = _mm512_cmpeq_epi32_mask(m_b, zero);
+    __mmask16 sat = _mm512_cmpgt_epi32_mask(e, _mm512_set1_epi32(FP16_MAX_EXP - 1)) | isZeroB;
+    ret = _mm512_mask_mov_epi32(ret, sat, _mm512_set1_epi32(FP16_MAX));
+    ret = _mm512_or_si512(ret, _mm512_slli_epi32(sign, FP16_SIGN_INDEX));
+    ret = _mm512_mask_mov_epi32(ret, _mm512_cmpeq_epi32_mask(m_a, zero) & ~isZeroB, zero);
+    return _mm512_cvtepi32_epi16(ret);
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static void Fp16DivAVX512(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m512i a = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)(src1 + i)));
+        __m512i b = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)(src2 + i)));
+        _mm256_storeu_si256((__m256i *)(dst + i), Fp16DivX16AVX512<roundMode>(a, b));
+    }
+    if (i < n){
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        __m512i a = _mm512_cvtepu16_epi32(_mm256_maskz_loadu_epi16(tail, src1 + i));
+        __m512i b = _mm512_cvtepu16_epi32(_mm256_maskz_loadu_epi16(tail, src2 + i));
+        _mm256_mask_storeu_epi16(dst + i, tail, Fp16DivX16AVX512<roundMode>(a, b));
+    }
+}
+FP16_AVX512_END
+#endif
+
+template <fp16RoundMode_t roundMode> static void Fp16DivDispatch(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        Fp16DivAVX512<roundMode>(src1, src2, dst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        Fp16DivAVX2<roundMode>(src1, src2, dst, n);
+        return;
+#endif
+    default://SSE2 has no variable shift, use scalar path
+        Fp16DivScalar(src1, src2, dst, n, roundMode);
+        return;
+    }
+}
+
+void fp16DivN(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    switch (roundMode){
+    case ROUND_TO_CEILING:
+        Fp16DivDispatch<ROUND_TO_CEILING>(src1, src2, dst, n);
+        break;
+    case ROUND_TO_FLOOR:
+        Fp16DivDispatch<ROUND_TO_FLOOR>(src1, src2, dst, n);
+        break;
+    case ROUND_BY_TRUNCATED:
+        Fp16DivDispatch<ROUND_BY_TRUNCATED>(src1, src2, dst, n);
+        break;
+    default:
+        Fp16DivDispatch<ROUND_TO_NEAREST>(src1, src2, dst, n);
+        break;
+    }
+}
+
+/*********************************exp/log of fp16_t*********************************/
+/**
+ *@ingroup fp16_array basic parameter
+ *@brief   relative error bound of the float approximations with margin, results whose
+ *         bound contains a rounding boundary of fp16_t are calculated exactly
+ */
+#define APPROX_REL_ERR                 (1.0f / (1 << 21))
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] h uint16_t value of fp16_t
+ *@brief   Scalar form of Fp16x4ToFloatSSE2, the same as fp16ToFloat with fewer branches
+ *@return  Return float/fp32 value of h
+ */
+static inline float Fp16BitsToFloat(uint16_t h){
+    uint32_t mag = h & FP16_ABS_MAX;
+    uint32_t bits = (mag << (FP32_MAN_LEN - FP16_MAN_LEN)) + FP16_TO_FP32_EXP_REBIAS;
+    float ret;
+    if (!(mag & FP16_EXP_MASK)){
+        ret = (float)mag * (1.0f / (1 << 24));
+        memcpy(&bits, &ret, sizeof(bits));
+    }
+    bits |= (uint32_t)(h >> FP16_SIGN_INDEX) << FP32_SIGN_INDEX;
+    memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in]  y   float approximation whose relative error is below APPROX_REL_ERR
+ *@param [out] ret uint16_t value of fp16_t
+ *@brief   Round y under roundMode, it is the rounded exact value when the error bound
+ *         of y contains no rounding boundary of fp16_t
+ *@return  Return false if the exact value is needed, which includes NaN y
+ */
+template <fp16RoundMode_t roundMode> static inline bool RoundApprox(float y, uint16_t *ret){
+    float lo = y * (1.0f - APPROX_REL_ERR);
+    float hi = y * (1.0f + APPROX_REL_ERR);
+    uint32_t loBits, hiBits;
+    memcpy(&loBits, &lo, sizeof(loBits));
+    memcpy(&hiBits, &hi, sizeof(hiBits));
+    *ret = FloatToFp16<roundMode>(loBits);
+    return (*ret == FloatToFp16<roundMode>(hiBits)) && (y == y);
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_array static method
+ *@brief   AVX2 lane version of RoundApprox, bit j of inexact is set if lane j needs the
+ *         exact value
+ *@return  Return eight fp16_t values in the low 16 bits of each lane
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static inline __m256i RoundApproxX8AVX2(__m256 y, int *inexact){
+    __m256i lo = FloatToFp16x8AVX2<roundMode>(_mm256_castps_si256(_mm256_mul_ps(y, _mm256_set1_ps(1.0f - APPROX_REL_ERR))));
+    __m256i hi = FloatToFp16x8AVX2<roundMode>(_mm256_castps_si256(_mm256_mul_ps(y, _mm256_set1_ps(1.0f + APPROX_REL_ERR))));
+    __m256 same = _mm256_and_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(lo, hi)), _mm256_cmp_ps(y, y, _CMP_ORD_Q));
+    *inexact = ~_mm256_movemask_ps(same) & 0xFF;
+    return lo;
+}
+
+FP16_AVX512_BEGIN
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static inline __m256i RoundApproxX16AVX512(__m512 y, __mmask16 *inexact){
+    __m256i lo = FloatToFp16x16AVX512<roundMode>(_mm512_castps_si512(_mm512_mul_ps(y, _mm512_set1_ps(1.0f - APPROX_REL_ERR))));
+    __m256i hi = FloatToFp16x16AVX512<roundMode>(_mm512_castps_si512(_mm512_mul_ps(y, _mm512_set1_ps(1.0f + APPROX_REL_ERR))));
+    *inexact = (__mmask16)~(_mm256_cmpeq_epi16_mask(lo, hi) & _mm512_cmp_ps_mask(y, y, _CMP_ORD_Q));
+    return lo;
+}
+FP16_AVX512_END
+#endif
+
+
+/**
+ *@ingroup fp16_array enum
+ *@brief   function of the exp/log kernels
+ */
+typedef enum tagFp16ExpLog
+{
+    EXPLOG_EXP = 0,
+    EXPLOG_LN,
+    EXPLOG_LOG2,
+    EXPLOG_LOG10,
+} fp16ExpLog_t;
+
+//exp: x = k*ln2 + r with ln2 = EXP_C1 + EXP_C2, |r| <= ln2/2, exp(r) = 1 + r + r^2*P(r)
+static const float EXP_ZERO = -745.25f;//exp in double is 0 below it, -745 is the last fp16_t above
+static const float EXP_C1 = 0.693359375f;
+static const float EXP_C2 = -2.12194440e-4f;
+static const float EXP_P[] = { 1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+                               4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f };
+//log: x = 2^k*(1+f) with sqrt(0.5) <= 1+f < sqrt(2), ln(1+f) = f - f^2/2 + f^3*P(f)
+static const float LOG_P[] = { 7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f,
+                               -1.2420140846e-1f, 1.4249322787e-1f, -1.6668057665e-1f,
+                               2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f };
+static const float LOG2EA = 0.44269504088896340736f;//log2(e)-1
+static const float LOG10EA = 4.3359375e-1f;//log10(e) = LOG10EA + LOG10EB
+static const float LOG10EB = 7.00731903251827651129e-4f;
+static const float LOG102A = 3.0078125e-1f;//log10(2) = LOG102A + LOG102B
+static const float LOG102B = 2.48745663981195213739e-4f;
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] x float value of a fp16_t
+ *@brief   Approximate exp/log of x in float. x beyond [-87, 12] is clamped for exp since
+ *         results stay below the minimum denormal or above FP16_MAX, and exp is 0 where
+ *         it is 0 in double; log of 0 is -inf and log of negative values is NaN
+ *@return  Return float approximation with relative error below APPROX_REL_ERR
+ */
+template <fp16ExpLog_t func> static float ExpLogApprox(float x){
+    if (EXPLOG_EXP == func){
+        if (x < EXP_ZERO){
+            return 0.0f;
+        }
+        x = std::min(std::max(x, -87.0f), 12.0f);
+        float k = std::floor(x * 1.44269504088896341f + 0.5f);
+        float r = x - k * EXP_C1 - k * EXP_C2;
+        float p = EXP_P[0];
+        for (int i = 1; i < 6; i++){
+            p = p * r + EXP_P[i];
+        }
+        float y = p * r * r + r + 1.0f;
+        uint32_t scale = (uint32_t)((int32_t)k + FP32_EXP_BIAS) << FP32_MAN_LEN;
+        float fScale;
+        memcpy(&fScale, &scale, sizeof(fScale));
+        return y * fScale;
+    }
+    if (x <= 0.0f){
+        return (x < 0.0f) ? std::numeric_limits<float>::quiet_NaN() : -std::numeric_limits<float>::infinity();
+    }
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    float k = (float)((int32_t)(bits >> FP32_MAN_LEN) - FP32_EXP_BIAS);
+    bits = (bits & FP32_MAN_MASK) | ((uint32_t)FP32_EXP_BIAS << FP32_MAN_LEN);
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+    if (m > 1.41421356f){
+        m *= 0.5f;
+        k += 1.0f;
+    }
+    float f = m - 1.0f;
+    float z = f * f;
+    float p = LOG_P[0];
+    for (int i = 1; i < 9; i++){
+        p = p * f + LOG_P[i];
+    }
+    float y = p * f * z - 0.5f * z;//ln(1+f) = f + y
+    switch (func){
+    case EXPLOG_LN:
+        return (f + (y + k * EXP_C2)) + k * EXP_C1;
+    case EXPLOG_LOG2:
+        return (((y * LOG2EA + f * LOG2EA) + y) + f) + k;
+    default:
+        return ((((y * LOG10EB + f * LOG10EB) + y * LOG10EA) + f * LOG10EA) + k * LOG102B) + k * LOG102A;
+    }
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] x value of a fp16_t
+ *@brief   Calculate exp/log of x by libm in double and round it once, this is the
+ *         result that the float approximations must reproduce
+ *@return  Return uint16_t value of fp16_t
+ */
+template <fp16RoundMode_t roundMode, fp16ExpLog_t func> static uint16_t ExpLogExact(double x){
+    double ret;
+    switch (func){
+    case EXPLOG_EXP:
+        ret = std::exp(x);
+        break;
+    case EXPLOG_LN:
+        ret = std::log(x);
+        break;
+    case EXPLOG_LOG2:
+        ret = std::log2(x);
+        break;
+    default:
+        ret = std::log10(x);
+        break;
+    }
+    uint64_t ui64;
+    memcpy(&ui64, &ret, sizeof(ui64));
+    return DoubleToFp16<roundMode>(ui64);
+}
+
+template <fp16RoundMode_t roundMode, fp16ExpLog_t func> static void ExpLogScalar(const uint16_t *src, uint16_t *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        float x = Fp16BitsToFloat(src[i]);
+        uint16_t ret;
+        if (!RoundApprox<roundMode>(ExpLogApprox<func>(x), &ret)){
+            ret = ExpLogExact<roundMode, func>(x);
+        }
+        dst[i] = ret;
+    }
+}
+
+#ifdef FP16_SIMD_X86
+template <fp16ExpLog_t func> FP16_TARGET_AVX2 static inline __m256 ExpLogApproxAVX2(__m256 x){
+    if (EXPLOG_EXP == func){
+        __m256 x0 = x;
+        x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-87.0f)), _mm256_set1_ps(12.0f));
+        __m256 k = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)),
+                                   _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256 r = _mm256_fnmadd_ps(k, _mm256_set1_ps(EXP_C1), x);
+        r = _mm256_fnmadd_ps(k, _mm256_set1_ps(EXP_C2), r);
+        __m256 p = _mm256_set1_ps(EXP_P[0]);
+        for (int i = 1; i < 6; i++){
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P[i]));
+        }
+        __m256 y = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+        __m256i scale = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(k), _mm256_set1_epi32(FP32_EXP_BIAS)), FP32_MAN_LEN);
+        y = _mm256_mul_ps(y, _mm256_castsi256_ps(scale));
+        return _mm256_andnot_ps(_mm256_cmp_ps(x0, _mm256_set1_ps(EXP_ZERO), _CMP_LT_OQ), y);
+    }
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 k = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, FP32_MAN_LEN), _mm256_set1_epi32(FP32_EXP_BIAS)));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(FP32_MAN_MASK)),
+                                                   _mm256_set1_epi32(FP32_EXP_BIAS << FP32_MAN_LEN)));
+    __m256 big = _mm256_cmp_ps(m, _mm256_set1_ps(1.41421356f), _CMP_GT_OQ);
+    m = _mm256_blendv_ps(m, _mm256_mul_ps(m, _mm256_set1_ps(0.5f)), big);
+    k = _mm256_add_ps(k, _mm256_and_ps(big, _mm256_set1_ps(1.0f)));
+    __m256 f = _mm256_sub_ps(m, _mm256_set1_ps(1.0f));
+    __m256 z = _mm256_mul_ps(f, f);
+    __m256 p = _mm256_set1_ps(LOG_P[0]);
+    for (int i = 1; i < 9; i++){
+        p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(LOG_P[i]));
+    }
+    __m256 y = _mm256_fmadd_ps(_mm256_mul_ps(p, f), z, _mm256_mul_ps(_mm256_set1_ps(-0.5f), z));
+    __m256 ret;
+    switch (func){
+    case EXPLOG_LN:
+        ret = _mm256_add_ps(f, _mm256_fmadd_ps(k, _mm256_set1_ps(EXP_C2), y));
+        ret = _mm256_fmadd_ps(k, _mm256_set1_ps(EXP_C1), ret);
+        break;
+    case EXPLOG_LOG2:
+        ret = _mm256_fmadd_ps(f, _mm256_set1_ps(LOG2EA), _mm256_mul_ps(y, _mm256_set1_ps(LOG2EA)));
+        ret = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(ret, y), f), k);
+        break;
+    default:
+        ret = _mm256_fmadd_ps(f, _mm256_set1_ps(LOG10EB), _mm256_mul_ps(y, _mm256_set1_ps(LOG10EB)));
+        ret = _mm256_fmadd_ps(y, _mm256_set1_ps(LOG10EA), ret);
+        ret = _mm256_fmadd_ps(f, _mm256_set1_ps(LOG10EA), ret);
+        ret = _mm256_fmadd_ps(k, _mm256_set1_ps(LOG102B), ret);
+        ret = _mm256_fmadd_ps(k, _mm256_set1_ps(LOG102A), ret);
+        break;
+    }
+    //log of 0 is -inf, log of negative values is NaN
+    __m256 isZero = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_EQ_OQ);
+    __m256 isNeg = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ);
+    ret = _mm256_blendv_ps(ret, _mm256_set1_ps(-std::numeric_limits<float>::infinity()), isZero);
+    return _mm256_blendv_ps(ret, _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN()), isNeg);
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@brief   Lanes whose error bound contains a rounding boundary or which are NaN are
+ *         recalculated by ExpLogExact
+ */
+template <fp16RoundMode_t roundMode, fp16ExpLog_t func> FP16_TARGET_AVX2 static void ExpLogAVX2(const uint16_t *src, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        __m256 x = Fp16x8ToFloatAVX2(_mm_loadu_si128((const __m128i *)(src + i)));
+        int exact;
+        __m256i lo = RoundApproxX8AVX2<roundMode>(ExpLogApproxAVX2<func>(x), &exact);
+        //x is saved before the store since dst can be the same as src
+        float xs[8];
+        _mm256_storeu_ps(xs, x);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi32(_mm256_castsi256_si128(lo), _mm256_extracti128_si256(lo, 1)));
+        for (int j = 0; exact; j++, exact >>= 1){
+            if (exact & 1){
+                dst[i + j] = ExpLogExact<roundMode, func>(xs[j]);
+            }
+        }
+    }
+    ExpLogScalar<roundMode, func>(src + i, dst + i, n - i);
+}
+
+FP16_AVX512_BEGIN
+template <fp16ExpLog_t func> FP16_TARGET_AVX512 static inline __m512 ExpLogApproxAVX512(__m512 x){
+    if (EXPLOG_EXP == func){
+        __m512 x0 = x;
+        x = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(-87.0f)), _mm512_set1_ps(12.0f));
+        __m512 k = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(1.44269504088896341f)),
+                                        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m512 r = _mm512_fnmadd_ps(k, _mm512_set1_ps(EXP_C1), x);
+        r = _mm512_fnmadd_ps(k, _mm512_set1_ps(EXP_C2), r);
+        __m512 p = _mm512_set1_ps(EXP_P[0]);
+        for (int i = 1; i < 6; i++){
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P[i]));
+        }
+        __m512 y = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+        __m512i scale = _mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(k), _mm512_set1_epi32(FP32_EXP_BIAS)), FP32_MAN_LEN);
+        y = _mm512_mul_ps(y, _mm512_castsi512_ps(scale));
+        return _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(x0, _mm512_set1_ps(EXP_ZERO), _CMP_GE_OQ), y);
+    }
+    __m512i bits = _mm512_castps_si512(x);
+    __m512 k = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(bits, FP32_MAN_LEN), _mm512_set1_epi32(FP32_EXP_BIAS)));
+    __m512 m = _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(FP32_MAN_MASK)),
+                                                   _mm512_set1_epi32(FP32_EXP_BIAS << FP32_MAN_LEN)));
+    __mmask16 big = _mm512_cmp_ps_mask(m, _mm512_set1_ps(1.41421356f), _CMP_GT_OQ);
+    m = _mm512_mask_mul_ps(m, big, m, _mm512_set1_ps(0.5f));
+    k = _mm512_mask_add_ps(k, big, k, _mm512_set1_ps(1.0f));
+    __m512 f = _mm512_sub_ps(m, _mm512_set1_ps(1.0f));
+    __m512 z = _mm512_mul_ps(f, f);
+    __m512 p = _mm512_set1_ps(LOG_P[0]);
+    for (int i = 1; i < 9; i++){
+        p = _mm512_fmadd_ps(p, f, _mm512_set1_ps(LOG_P[i]));
+    }
+    __m512 y = _mm512_fmadd_ps(_mm512_mul_ps(p, f), z, _mm512_mul_ps(_mm512_set1_ps(-0.5f), z));
+    __m512 ret;
+    switch (func){
+    case EXPLOG_LN:
+        ret = _mm512_add_ps(f, _mm512_fmadd_ps(k, _mm512_set1_ps(EXP_C2), y));
+        ret = _mm512_fmadd_ps(k, _mm512_set1_ps(EXP_C1), ret);
+        break;
+    case EXPLOG_LOG2:
+        ret = _mm512_fmadd_ps(f, _mm512_set1_ps(LOG2EA), _mm512_mul_ps(y, _mm512_set1_ps(LOG2EA)));
+        ret = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(ret, y), f), k);
+        break;
+    default:
+        ret = _mm512_fmadd_ps(f, _mm512_set1_ps(LOG10EB), _mm512_mul_ps(y, _mm512_set1_ps(LOG10EB)));
+        ret = _mm512_fmadd_ps(y, _mm512_set1_ps(LOG10EA), ret);
+        ret = _mm512_fmadd_ps(f, _mm512_set1_ps(LOG10EA), ret);
+        ret = _mm512_fmadd_ps(k, _mm512_set1_ps(LOG102B), ret);
+        ret = _mm512_fmadd_ps(k, _mm512_set1_ps(LOG102A), ret);
+        break;
+    }
+    //log of 0 is -inf, log of negative values is NaN
+    ret = _mm512_mask_mov_ps(ret, _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_EQ_OQ),
+                             _mm512_set1_ps(-std::numeric_limits<float>::infinity()));
+    return _mm512_mask_mov_ps(ret, _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_LT_OQ),
+                              _mm512_set1_ps(std::numeric_limits<float>::quiet_NaN()));
+}
+
+template <fp16RoundMode_t roundMode, fp16ExpLog_t func> FP16_TARGET_AVX512 static inline void ExpLogX16AVX512(const uint16_t *src, uint16_t *dst, __mmask16 mask){
+    __m512 x = Fp16x16ToFloatAVX512(_mm256_maskz_loadu_epi16(mask, src));
+    __mmask16 inexact;
+    __m256i lo = RoundApproxX16AVX512<roundMode>(ExpLogApproxAVX512<func>(x), &inexact);
+    uint32_t exact = (uint32_t)(mask & inexact);
+    //x is saved before the store since dst can be the same as src
+    float xs[16];
+    _mm512_storeu_ps(xs, x);
+    _mm256_mask_storeu_epi16(dst, mask, lo);
+    for (int j = 0; exact; j++, exact >>= 1){
+        if (exact & 1){
+            dst[j] = ExpLogExact<roundMode, func>(xs[j]);
+        }
+    }
+}
+
+template <fp16RoundMode_t roundMode, fp16ExpLog_t func> FP16_TARGET_AVX512 static void ExpLogAVX512(const uint16_t *src, uint16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        ExpLogX16AVX512<roundMode, func>(src + i, dst + i, 0xFFFF);
+    }
+    if (i < n){
+        ExpLogX16AVX512<roundMode, func>(src + i, dst + i, (__mmask16)((1u << (n - i)) - 1));
+    }
+}
+FP16_AVX512_END
+#endif
+
+template <fp16RoundMode_t roundMode, fp16ExpLog_t func> static void ExpLogDispatch(const uint16_t *src, uint16_t *dst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        ExpLogAVX512<roundMode, func>(src, dst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        ExpLogAVX2<roundMode, func>(src, dst, n);
+        return;
+#endif
+    default://the rounding check uses FloatToFp16 which has no SSE2 kernel
+        ExpLogScalar<roundMode, func>(src, dst, n);
+        return;
+    }
+}
+
+template <fp16ExpLog_t func> static void ExpLogByMode(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    switch (roundMode){
+    case ROUND_TO_CEILING:
+        ExpLogDispatch<ROUND_TO_CEILING, func>(src, dst, n);
+        break;
+    case ROUND_TO_FLOOR:
+        ExpLogDispatch<ROUND_TO_FLOOR, func>(src, dst, n);
+        break;
+    case ROUND_BY_TRUNCATED:
+        ExpLogDispatch<ROUND_BY_TRUNCATED, func>(src, dst, n);
+        break;
+    default:
+        ExpLogDispatch<ROUND_TO_NEAREST, func>(src, dst, n);
+        break;
+    }
+}
+
+void fp16ExpN(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    ExpLogByMode<EXPLOG_EXP>(src, dst, n, roundMode);
+}
+
+void fp16LnN(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    ExpLogByMode<EXPLOG_LN>(src, dst, n, roundMode);
+}
+
+void fp16Log2N(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    ExpLogByMode<EXPLOG_LOG2>(src, dst, n, roundMode);
+}
+
+void fp16Log10N(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    ExpLogByMode<EXPLOG_LOG10>(src, dst, n, roundMode);
+}
+
+/*********************************sin/cos of fp16_t*********************************/
+//|fp16_t| < 2^17, so k of x = k*pi/2 + r has at most 17 bits and Cody-Waite reduction
+//is enough: pi/2 = SINCOS_PIO2_1 + SINCOS_PIO2_2 + SINCOS_PIO2_3 and k*SINCOS_PIO2_1 is
+//exact under fma. All pieces are positive so that k = +0 keeps r = x = -0
+static const float SINCOS_PIO2_1 = 1.57079625e+00f;
+static const float SINCOS_PIO2_2 = 7.54978942e-08f;
+static const float SINCOS_PIO2_3 = 5.39030295e-15f;
+static const float SINCOS_2OPI = 0.636619772f;
+//sin(r) = r*(1 + r^2*P(r^2)), cos(r) = 1 - r^2/2 + r^4*Q(r^2) for |r| <= pi/4
+static const float SIN_P[] = { -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f };
+static const float COS_P[] = { 2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f };
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] x value of a fp16_t
+ *@brief   Calculate sin by libm in double, narrowed through float as hf_sin does
+ *@return  Return uint16_t value of fp16_t
+ */
+template <fp16RoundMode_t roundMode> static uint16_t SinExact(double x){
+    float ret = (float)std::sin(x);
+    uint32_t ui32;
+    memcpy(&ui32, &ret, sizeof(ui32));
+    return FloatToFp16<roundMode>(ui32);
+}
+
+template <fp16RoundMode_t roundMode> static uint16_t CosExact(double x){
+    double ret = std::cos(x);
+    uint64_t ui64;
+    memcpy(&ui64, &ret, sizeof(ui64));
+    return DoubleToFp16<roundMode>(ui64);
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@brief   sin and/or cos of an array by libm, sinDst and cosDst are written only if doSin
+ *         and doCos, either of them can be the same as src. libm is faster than the
+ *         polynomials with the rounding check for single elements
+ */
+template <fp16RoundMode_t roundMode, bool doSin, bool doCos> static void SinCosScalar(const uint16_t *src, uint16_t *sinDst, uint16_t *cosDst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        double x = Fp16BitsToFloat(src[i]);
+        if (doSin){
+            sinDst[i] = SinExact<roundMode>(x);
+        }
+        if (doCos){
+            cosDst[i] = CosExact<roundMode>(x);
+        }
+    }
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_array static method
+ *@param [in]  x float value of fp16_t lanes
+ *@param [out] s float approximation of sin(x)
+ *@param [out] c float approximation of cos(x)
+ *@brief   Reduce x to r = x - k*pi/2 with |r| <= pi/4 by fma with three pieces of pi/2,
+ *         evaluate sin(r) and cos(r) and select them by quadrant k mod 4
+ */
+FP16_TARGET_AVX2 static inline void SinCosApproxAVX2(__m256 x, __m256 *s, __m256 *c){
+    __m256 k = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(SINCOS_2OPI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    k = _mm256_add_ps(k, _mm256_setzero_ps());//-0 to +0, so that r keeps the sign of x = -0
+    __m256 r = _mm256_fnmadd_ps(k, _mm256_set1_ps(SINCOS_PIO2_1), x);
+    r = _mm256_fnmadd_ps(k, _mm256_set1_ps(SINCOS_PIO2_2), r);
+    r = _mm256_fnmadd_ps(k, _mm256_set1_ps(SINCOS_PIO2_3), r);
+    __m256 z = _mm256_mul_ps(r, r);
+    __m256 p = _mm256_fmadd_ps(_mm256_set1_ps(SIN_P[0]), z, _mm256_set1_ps(SIN_P[1]));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(SIN_P[2]));
+    __m256 sinR = _mm256_mul_ps(r, _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f)));
+    p = _mm256_fmadd_ps(_mm256_set1_ps(COS_P[0]), z, _mm256_set1_ps(COS_P[1]));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(COS_P[2]));
+    __m256 cosR = _mm256_fmadd_ps(_mm256_mul_ps(p, z), z, _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, _mm256_set1_ps(1.0f)));
+
+    __m256i q = _mm256_cvtps_epi32(k);
+    __m256 swap = _mm256_castsi256_ps(_mm256_slli_epi32(q, FP32_SIGN_INDEX));
+    __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), FP32_SIGN_INDEX - 1));
+    __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), FP32_SIGN_INDEX - 1));
+    *s = _mm256_xor_ps(_mm256_blendv_ps(sinR, cosR, swap), sinSign);
+    *c = _mm256_xor_ps(_mm256_blendv_ps(cosR, sinR, swap), cosSign);
+}
+
+template <fp16RoundMode_t roundMode, bool doSin, bool doCos> FP16_TARGET_AVX2 static void SinCosAVX2(const uint16_t *src, uint16_t *sinDst, uint16_t *cosDst, size_t n){
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        __m256 x = Fp16x8ToFloatAVX2(_mm_loadu_si128((const __m128i *)(src + i)));
+        __m256 s, c;
+        int sinExact = 0, cosExact = 0;
+        __m256i sinH = _mm256_setzero_si256(), cosH = _mm256_setzero_si256();
+        SinCosApproxAVX2(x, &s, &c);
+        if (doSin){
+            sinH = RoundApproxX8AVX2<roundMode>(s, &sinExact);
+        }
+        if (doCos){
+            cosH = RoundApproxX8AVX2<roundMode>(c, &cosExact);
+        }
+        //x is saved before the store since the results can be the same as src
+        float xs[8];
+        _mm256_storeu_ps(xs, x);
+        if (doSin){
+            _mm_storeu_si128((__m128i *)(sinDst + i), _mm_packus_epi32(_mm256_castsi256_si128(sinH), _mm256_extracti128_si256(sinH, 1)));
+        }
+        if (doCos){
+            _mm_storeu_si128((__m128i *)(cosDst + i), _mm_packus_epi32(_mm256_castsi256_si128(cosH), _mm256_extracti128_si256(cosH, 1)));
+        }
+        for (int j = 0; sinExact; j++, sinExact >>= 1){
+            if (sinExact & 1){
+                sinDst[i + j] = SinExact<roundMode>(xs[j]);
+            }
+        }
+        for (int j = 0; cosExact; j++, cosExact >>= 1){
+            if (cosExact & 1){
+                cosDst[i + j] = CosExact<roundMode>(xs[j]);
+            }
+        }
+    }
+    SinCosScalar<roundMode, doSin, doCos>(src + i, (doSin ? sinDst + i : sinDst), (doCos ? cosDst + i : cosDst), n - i);
+}
+
+FP16_AVX512_BEGIN
+FP16_TARGET_AVX512 static inline void SinCosApproxAVX512(__m512 x, __m512 *s, __m512 *c){
+    __m512 k = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(SINCOS_2OPI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    k = _mm512_add_ps(k, _mm512_setzero_ps());//-0 to +0, so that r keeps the sign of x = -0
+    __m512 r = _mm512_fnmadd_ps(k, _mm512_set1_ps(SINCOS_PIO2_1), x);
+    r = _mm512_fnmadd_ps(k, _mm512_set1_ps(SINCOS_PIO2_2), r);
+    r = _mm512_fnmadd_ps(k, _mm512_set1_ps(SINCOS_PIO2_3), r);
+    __m512 z = _mm512_mul_ps(r, r);
+    __m512 p = _mm512_fmadd_ps(_mm512_set1_ps(SIN_P[0]), z, _mm512_set1_ps(SIN_P[1]));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(SIN_P[2]));
+    __m512 sinR = _mm512_mul_ps(r, _mm512_fmadd_ps(p, z, _mm512_set1_ps(1.0f)));
+    p = _mm512_fmadd_ps(_mm512_set1_ps(COS_P[0]), z, _mm512_set1_ps(COS_P[1]));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(COS_P[2]));
+    __m512 cosR = _mm512_fmadd_ps(_mm512_mul_ps(p, z), z, _mm512_fnmadd_ps(_mm512_set1_ps(0.5f), z, _mm512_set1_ps(1.0f)));
+
+    __m512i q = _mm512_cvtps_epi32(k);
+    __mmask16 swap = _mm512_test_epi32_mask(q, _mm512_set1_epi32(1));
+    __m512i sinSign = _mm512_slli_epi32(_mm512_and_si512(q, _mm512_set1_epi32(2)), FP32_SIGN_INDEX - 1);
+    __m512i cosSign = _mm512_slli_epi32(_mm512_and_si512(_mm512_add_epi32(q, _mm512_set1_epi32(1)), _mm512_set1_epi32(2)), FP32_SIGN_INDEX - 1);
+    *s = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_mask_mov_ps(sinR, swap, cosR)), sinSign));
+    *c = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_mask_mov_ps(cosR, swap, sinR)), cosSign));
+}
+
+template <fp16RoundMode_t roundMode, bool doSin, bool doCos> FP16_TARGET_AVX512 static inline void SinCosX16AVX512(const uint16_t *src, uint16_t *sinDst, uint16_t *cosDst, __mmask16 mask){
+    __m512 x = Fp16x16ToFloatAVX512(_mm256_maskz_loadu_epi16(mask, src));
+    __m512 s, c;
+    __mmask16 sinInexact = 0, cosInexact = 0;
+    __m256i sinH = _mm256_setzero_si256(), cosH = _mm256_setzero_si256();
+    SinCosApproxAVX512(x, &s, &c);
+    if (doSin){
+        sinH = RoundApproxX16AVX512<roundMode>(s, &sinInexact);
+    }
+    if (doCos){
+        cosH = RoundApproxX16AVX512<roundMode>(c, &cosInexact);
+    }
+    //x is saved before the store since the results can be the same as src
+    float xs[16];
+    _mm512_storeu_ps(xs, x);
+    if (doSin){
+        _mm256_mask_storeu_epi16(sinDst, mask, sinH);
+    }
+    if (doCos){
+        _mm256_mask_storeu_epi16(cosDst, mask, cosH);
+    }
+    for (uint32_t exact = mask & sinInexact, j = 0; exact; j++, exact >>= 1){
+        if (exact & 1){
+            sinDst[j] = SinExact<roundMode>(xs[j]);
+        }
+    }
+    for (uint32_t exact = mask & cosInexact, j = 0; exact; j++, exact >>= 1){
+        if (exact & 1){
+            cosDst[j] = CosExact<roundMode>(xs[j]);
+        }
+    }
+}
+
+template <fp16RoundMode_t roundMode, bool doSin, bool doCos> FP16_TARGET_AVX512 static void SinCosAVX512(const uint16_t *src, uint16_t *sinDst, uint16_t *cosDst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        SinCosX16AVX512<roundMode, doSin, doCos>(src + i, (doSin ? sinDst + i : sinDst), (doCos ? cosDst + i : cosDst), 0xFFFF);
+    }
+    if (i < n){
+        SinCosX16AVX512<roundMode, doSin, doCos>(src + i, (doSin ? sinDst + i : sinDst), (doCos ? cosDst + i : cosDst),
+                                                 (__mmask16)((1u << (n - i)) - 1));
+    }
+}
+FP16_AVX512_END
+#endif
+
+template <fp16RoundMode_t roundMode, bool doSin, bool doCos> static void SinCosDispatch(const uint16_t *src, uint16_t *sinDst, uint16_t *cosDst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        SinCosAVX512<roundMode, doSin, doCos>(src, sinDst, cosDst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        SinCosAVX2<roundMode, doSin, doCos>(src, sinDst, cosDst, n);
+        return;
+#endif
+    default://no SSE2 kernel, see SinCosScalar
+        SinCosScalar<roundMode, doSin, doCos>(src, sinDst, cosDst, n);
+        return;
+    }
+}
+
+template <bool doSin, bool doCos> static void SinCosByMode(const uint16_t *src, uint16_t *sinDst, uint16_t *cosDst, size_t n, fp16RoundMode_t roundMode){
+    switch (roundMode){
+    case ROUND_TO_CEILING:
+        SinCosDispatch<ROUND_TO_CEILING, doSin, doCos>(src, sinDst, cosDst, n);
+        break;
+    case ROUND_TO_FLOOR:
+        SinCosDispatch<ROUND_TO_FLOOR, doSin, doCos>(src, sinDst, cosDst, n);
+        break;
+    case ROUND_BY_TRUNCATED:
+        SinCosDispatch<ROUND_BY_TRUNCATED, doSin, doCos>(src, sinDst, cosDst, n);
+        break;
+    default:
+        SinCosDispatch<ROUND_TO_NEAREST, doSin, doCos>(src, sinDst, cosDst, n);
+        break;
+    }
+}
+
+void fp16SinN(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    SinCosByMode<true, false>(src, dst, NULL, n, roundMode);
+}
+
+void fp16CosN(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode){
+    SinCosByMode<false, true>(src, NULL, dst, n, roundMode);
+}
+
+void fp16SinCosN(const uint16_t *src, uint16_t *sinDst, uint16_t *cosDst, size_t n, fp16RoundMode_t roundMode){
+    SinCosByMode<true, true>(src, sinDst, cosDst, n, roundMode);
+}
+
+/*********************************fp16_t operators*********************************/
+/**
+ *@ingroup fp16_array static method
+ *@brief   round mode of fp16_t operators under g_RoundMode of this thread
+ */
+static fp16RoundMode_t OperatorRoundMode(){
+    return (ROUND_TO_NEAREST == g_RoundMode) ? ROUND_TO_NEAREST : ROUND_BY_TRUNCATED;
+}
+
+void hf_addN(const fp16_t *src1, const fp16_t *src2, fp16_t *dst, size_t n){
+    fp16AddN(&src1->val, &src2->val, &dst->val, n, OperatorRoundMode());
+}
+
+void hf_subN(const fp16_t *src1, const fp16_t *src2, fp16_t *dst, size_t n){
+    fp16SubN(&src1->val, &src2->val, &dst->val, n, OperatorRoundMode());
+}
+
+void hf_mulN(const fp16_t *src1, const fp16_t *src2, fp16_t *dst, size_t n){
+    fp16MulN(&src1->val, &src2->val, &dst->val, n, OperatorRoundMode());
+}
+
+void hf_divN(const fp16_t *src1, const fp16_t *src2, fp16_t *dst, size_t n){
+    fp16DivN(&src1->val, &src2->val, &dst->val, n, OperatorRoundMode());
+}
+
+/*********************************deq(fixed point)*********************************/
+/**
+ *@ingroup fp16_array basic parameter
+ *@brief   scales repeated for short channel counts, so that vector loops see long rows
+ */
+#define DEQ_SCALE_ROW                  (256)
+
+static void DeqScalar(const uint32_t *src, const uint16_t *scale, size_t scaleStep, uint16_t *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        fp16_t fpScale(scale[i * scaleStep]);
+        dst[i] = deq(src[i], fpScale).val;
+    }
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_array static method
+ *@param [in] fix eight signed 1.14.17 fixed-point values
+ *@brief   Decode fixed-point values to fp16_t as deq does without its bit loop: the leading
+ *         one at bit L sets exponent L-2 and the 32 bits window below it; for L<=2 the
+ *         exponent is 0 and the window is the magnitude shifted by 30 bits. Rounding does
+ *         not carry into the exponent, the same as deq
+ *@return  Return eight fp16_t values in the low 16 bits of each lane
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static inline __m256i DeqDecodeX8AVX2(__m256i fix){
+    __m256i mag = _mm256_and_si256(fix, _mm256_set1_epi32(FP32_ABS_MAX));
+    //a leading one without a neighbour converts to float exactly, its exponent is L
+    __m256i lead = _mm256_andnot_si256(_mm256_srli_epi32(mag, 1), mag);
+    __m256i top = _mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(lead)), FP32_MAN_LEN),
+                                   _mm256_set1_epi32(FP32_EXP_BIAS));
+    __m256i normal = _mm256_cmpgt_epi32(top, _mm256_set1_epi32(2));
+    __m256i shift = _mm256_blendv_epi8(_mm256_set1_epi32(30), _mm256_sub_epi32(_mm256_set1_epi32(32), top), normal);
+    __m256i e = _mm256_and_si256(normal, _mm256_sub_epi32(top, _mm256_set1_epi32(2)));
+    __m256i dcml = _mm256_sllv_epi32(mag, shift);
+    __m256i m = _mm256_srli_epi32(dcml, 22);
+    if (ROUND_TO_NEAREST == roundMode){
+        __m256i half = _mm256_cmpeq_epi32(_mm256_and_si256(dcml, _mm256_set1_epi32(0x200000)), _mm256_setzero_si256());
+        __m256i rest = _mm256_cmpeq_epi32(_mm256_and_si256(dcml, _mm256_set1_epi32(0x5FFFFF)), _mm256_setzero_si256());
+        m = _mm256_add_epi32(m, _mm256_andnot_si256(_mm256_or_si256(half, rest), _mm256_set1_epi32(1)));
+    }
+    m = _mm256_and_si256(m, _mm256_set1_epi32(FP16_MAN_MASK));
+    __m256i s = _mm256_and_si256(_mm256_srli_epi32(fix, 16), _mm256_set1_epi32(FP16_SIGN_MASK));
+    return _mm256_or_si256(_mm256_or_si256(s, _mm256_slli_epi32(e, FP16_MAN_LEN)), m);
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@brief   Dequantize eight values: decode, multiply by the fp16_t operator and add 17 to
+ *         the exponent of the product, a denormal product counts as exponent 1
+ *@return  Return eight fp16_t values in the low 16 bits of each lane
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static inline __m256i DeqX8AVX2(__m256i fix, __m128i scale){
+    __m256i x = DeqDecodeX8AVX2<roundMode>(fix);
+    __m128i x16 = _mm_packus_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+    __m256i p = Fp16MulX8AVX2<roundMode>(x16, scale);
+    __m256i e = _mm256_and_si256(_mm256_srli_epi32(p, FP16_MAN_LEN), _mm256_set1_epi32(FP16_MAX_EXP));
+    e = _mm256_add_epi32(_mm256_max_epi32(e, _mm256_set1_epi32(1)), _mm256_set1_epi32(17));
+    __m256i s = _mm256_and_si256(p, _mm256_set1_epi32(FP16_SIGN_MASK));
+    __m256i r = _mm256_or_si256(_mm256_and_si256(p, _mm256_set1_epi32(FP16_SIGN_MASK | FP16_MAN_MASK)), _mm256_slli_epi32(e, FP16_MAN_LEN));
+    __m256i over = _mm256_cmpgt_epi32(e, _mm256_set1_epi32(FP16_MAX_VALID_EXP));
+    return _mm256_blendv_epi8(r, _mm256_or_si256(s, _mm256_set1_epi32(FP16_MAX)), over);
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@param [in] scaleStep 1 to take scale[i] for element i, 0 to take scale[0] for all
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX2 static void DeqAVX2(const uint32_t *src, const uint16_t *scale, size_t scaleStep, uint16_t *dst, size_t n){
+    __m128i sc = _mm_set1_epi16((short)scale[0]);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        if (scaleStep){
+            sc = _mm_loadu_si128((const __m128i *)(scale + i));
+        }
+        __m256i r = DeqX8AVX2<roundMode>(_mm256_loadu_si256((const __m256i *)(src + i)), sc);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1)));
+    }
+    DeqScalar(src + i, scale + i * scaleStep, scaleStep, dst + i, n - i);
+}
+
+FP16_AVX512_BEGIN
+/**
+ *@ingroup fp16_array static method
+ *@brief   AVX-512 lane version of DeqDecodeX8AVX2
+ *@return  Return sixteen fp16_t values
+ */
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static inline __m256i DeqDecodeX16AVX512(__m512i fix){
+    __m512i mag = _mm512_and_si512(fix, _mm512_set1_epi32(FP32_ABS_MAX));
+    __m512i lead = _mm512_andnot_si512(_mm512_srli_epi32(mag, 1), mag);
+    __m512i top = _mm512_sub_epi32(_mm512_srli_epi32(_mm512_castps_si512(_mm512_cvtepi32_ps(lead)), FP32_MAN_LEN),
+                                   _mm512_set1_epi32(FP32_EXP_BIAS));
+    __mmask16 normal = _mm512_cmpgt_epi32_mask(top, _mm512_set1_epi32(2));
+    __m512i shift = _mm512_mask_sub_epi32(_mm512_set1_epi32(30), normal, _mm512_set1_epi32(32), top);
+    __m512i e = _mm512_maskz_sub_epi32(normal, top, _mm512_set1_epi32(2));
+    __m512i dcml = _mm512_sllv_epi32(mag, shift);
+    __m512i m = _mm512_srli_epi32(dcml, 22);
+    if (ROUND_TO_NEAREST == roundMode){
+        __mmask16 up = _mm512_test_epi32_mask(dcml, _mm512_set1_epi32(0x200000)) &
+                       _mm512_test_epi32_mask(dcml, _mm512_set1_epi32(0x5FFFFF));
+        m = _mm512_mask_add_epi32(m, up, m, _mm512_set1_epi32(1));
+    }
+    m = _mm512_and_si512(m, _mm512_set1_epi32(FP16_MAN_MASK));
+    __m512i s = _mm512_and_si512(_mm512_srli_epi32(fix, 16), _mm512_set1_epi32(FP16_SIGN_MASK));
+    return _mm512_cvtepi32_epi16(_mm512_or_si512(_mm512_or_si512(s, _mm512_slli_epi32(e, FP16_MAN_LEN)), m));
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static inline __m256i DeqX16AVX512(__m512i fix, __m256i scale){
+    __m256i p = Fp16MulX16AVX512<roundMode>(DeqDecodeX16AVX512<roundMode>(fix), scale);
+    __m256i e = _mm256_and_si256(_mm256_srli_epi16(p, FP16_MAN_LEN), _mm256_set1_epi16(FP16_MAX_EXP));
+    e = _mm256_add_epi16(_mm256_max_epi16(e, _mm256_set1_epi16(1)), _mm256_set1_epi16(17));
+    __mmask16 over = _mm256_cmpgt_epi16_mask(e, _mm256_set1_epi16(FP16_MAX_VALID_EXP));
+    __m256i s = _mm256_and_si256(p, _mm256_set1_epi16((short)FP16_SIGN_MASK));
+    __m256i r = _mm256_or_si256(_mm256_and_si256(p, _mm256_set1_epi16((short)(FP16_SIGN_MASK | FP16_MAN_MASK))), _mm256_slli_epi16(e, FP16_MAN_LEN));
+    return _mm256_mask_mov_epi16(r, over, _mm256_or_si256(s, _mm256_set1_epi16(FP16_MAX)));
+}
+
+template <fp16RoundMode_t roundMode> FP16_TARGET_AVX512 static void DeqAVX512(const uint32_t *src, const uint16_t *scale, size_t scaleStep, uint16_t *dst, size_t n){
+    __m256i sc = _mm256_set1_epi16((short)scale[0]);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        if (scaleStep){
+            sc = _mm256_loadu_si256((const __m256i *)(scale + i));
+        }
+        _mm256_storeu_si256((__m256i *)(dst + i), DeqX16AVX512<roundMode>(_mm512_loadu_si512((const void *)(src + i)), sc));
+    }
+    if (i < n){
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        if (scaleStep){
+            sc = _mm256_maskz_loadu_epi16(tail, scale + i);
+        }
+        __m512i fix = _mm512_maskz_loadu_epi32(tail, src + i);
+        _mm256_mask_storeu_epi16(dst + i, tail, DeqX16AVX512<roundMode>(fix, sc));
+    }
+}
+FP16_AVX512_END
+#endif
+
+template <fp16RoundMode_t roundMode> static void DeqDispatch(const uint32_t *src, const uint16_t *scale, size_t scaleStep, uint16_t *dst, size_t n){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        DeqAVX512<roundMode>(src, scale, scaleStep, dst, n);
+        return;
+    case SIMD_LEVEL_AVX2:
+        DeqAVX2<roundMode>(src, scale, scaleStep, dst, n);
+        return;
+#endif
+    default://SSE2 has no variable shift, use scalar path
+        DeqScalar(src, scale, scaleStep, dst, n);
+        return;
+    }
+}
+
+/**
+ *@ingroup fp16_array static method
+ *@brief   deq rounds as the fp16_t operators do
+ */
+static void DeqByMode(const uint32_t *src, const uint16_t *scale, size_t scaleStep, uint16_t *dst, size_t n){
+    if (ROUND_TO_NEAREST == OperatorRoundMode()){
+        DeqDispatch<ROUND_TO_NEAREST>(src, scale, scaleStep, dst, n);
+    }
+    else{
+        DeqDispatch<ROUND_BY_TRUNCATED>(src, scale, scaleStep, dst, n);
+    }
+}
+
+void deqN(const uint32_t *fixVal, size_t n, fp16_t fpScale, fp16_t *ret){
+    DeqByMode(fixVal, &fpScale.val, 0, &ret->val, n);
+}
+
+void deqN(const uint32_t *fixVal, size_t n, const fp16_t *fpScale, size_t channels, fp16_t *ret){
+    if (n == 0 || channels == 0){
+        return;
+    }
+    //rows of a few channels are joined so that every call covers DEQ_SCALE_ROW elements or more
+    uint16_t joined[DEQ_SCALE_ROW * 2];
+    const uint16_t *scale = &fpScale->val;
+    size_t row = channels;
+    if (channels < DEQ_SCALE_ROW){
+        row = channels * (DEQ_SCALE_ROW / channels + 1);
+        for (size_t i = 0; i < row; i++){
+            joined[i] = fpScale[i % channels].val;
+        }
+        scale = joined;
+    }
+    for (size_t i = 0; i < n; i += row){
+        DeqByMode(fixVal + i, scale, 1, &ret[i].val, std::min(row, n - i));
+    }
+}
@@ -0,0 +1,183 @@
+/**
+ * @file fp16_array.h
+ *
+ * Copyright(C), 2017 - 2018, Lxzh Tech. Co., Ltd. ALL RIGHTS RESERVED.
+ *
+ * @brief array methods of Half precision float
+ *
+ * @version 1.0
+ *
+ */
+#ifndef _FP16_ARRAY_H_
+#define _FP16_ARRAY_H_
+
+#include <stddef.h>
+#include "fp16_t.h"
+#include "fp16_simd.h"
+
+/**
+ *@ingroup fp16_t array conversion method
+ *@param [in]  src uint16_t values of fp16_t objects
+ *@param [out] dst float/fp32 results
+ *@param [in]  n   element count
+ *@brief   Convert an array of fp16_t to float/fp32, every element is bit-exact with fp16ToFloat
+ */
+void fp16ToFloatN(const uint16_t *src, float *dst, size_t n);
+/**
+ *@ingroup fp16_t array conversion method
+ *@param [in]  src       float/fp32 values
+ *@param [out] dst       uint16_t values of fp16_t results
+ *@param [in]  n         element count
+ *@param [in]  roundMode round mode, default is round to nearest
+ *@brief   Convert an array of float/fp32 to fp16_t, overflow, inf and NaN saturate to
+ *         signed FP16_MAX; ROUND_TO_NEAREST is bit-exact with fp16_t::operator=(const float&)
+ */
+void floatToFp16N(const float *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+/**
+ *@ingroup fp16_t array conversion method
+ *@param [in]  src uint16_t values of fp16_t objects
+ *@param [out] dst double/fp64 results
+ *@param [in]  n   element count
+ *@brief   Convert an array of fp16_t to double/fp64, every element is bit-exact with fp16ToDouble
+ */
+void fp16ToDoubleN(const uint16_t *src, double *dst, size_t n);
+/**
+ *@ingroup fp16_t array conversion method
+ *@param [in]  src       double/fp64 values
+ *@param [out] dst       uint16_t values of fp16_t results
+ *@param [in]  n         element count
+ *@param [in]  roundMode round mode, default is round to nearest
+ *@brief   Convert an array of double/fp64 to fp16_t with a single rounding, not through float.
+ *         Overflow, inf and NaN saturate to signed FP16_MAX; ROUND_TO_NEAREST and
+ *         ROUND_BY_TRUNCATED are bit-exact with fp16_t::operator=(const double&) under the
+ *         same g_RoundMode
+ */
+void doubleToFp16N(const double *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+/**
+ *@ingroup fp16_t array conversion method
+ *@param [in]  src       uint16_t values of fp16_t objects
+ *@param [out] dst       integer results
+ *@param [in]  n         element count
+ *@param [in]  roundMode round mode, default is round to nearest
+ *@brief   Convert an array of fp16_t to integer with saturation. ROUND_TO_NEAREST and
+ *         ROUND_BY_TRUNCATED are bit-exact with fp16ToInt8 ~ fp16ToUInt32 under the same
+ *         g_RoundMode; ROUND_TO_CEILING and ROUND_TO_FLOOR round as fp16ToInt32 does,
+ *         denormals included. fp16ToInt32N is bit-exact with fp16ToInt32 for every roundMode
+ */
+void fp16ToInt8N(const uint16_t *src, int8_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16ToUInt8N(const uint16_t *src, uint8_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16ToInt16N(const uint16_t *src, int16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16ToUInt16N(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16ToInt32N(const uint16_t *src, int32_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16ToUInt32N(const uint16_t *src, uint32_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+/**
+ *@ingroup fp16_t array conversion method
+ *@param [in]  src       integer values
+ *@param [out] dst       uint16_t values of fp16_t results
+ *@param [in]  n         element count
+ *@param [in]  roundMode round mode, default is round to nearest
+ *@brief   Convert an array of integer to fp16_t. ROUND_TO_NEAREST and ROUND_BY_TRUNCATED are
+ *         bit-exact with fp16_t::operator= of the integer type under the same g_RoundMode,
+ *         including its saturation of int32_t/uint32_t, exponent 31 of uint16_t and -0 for
+ *         -128 of int8_t; INT32_MIN saturates to FP16_MIN
+ */
+void int8ToFp16N(const int8_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void uint8ToFp16N(const uint8_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void int16ToFp16N(const int16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void uint16ToFp16N(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void int32ToFp16N(const int32_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void uint32ToFp16N(const uint32_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+/**
+ *@ingroup fp16_t array math method
+ *@param [in]  src1      uint16_t values of fp16_t dividends
+ *@param [in]  src2      uint16_t values of fp16_t divisors
+ *@param [out] dst       uint16_t values of fp16_t quotients
+ *@param [in]  n         element count
+ *@param [in]  roundMode round mode, default is round to nearest
+ *@brief   Divide arrays of fp16_t elementwise, every element is bit-exact with fp16_div
+ */
+void fp16DivN(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+
+/**
+ *@ingroup fp16_t array math method
+ *@param [in]  src1      uint16_t values of fp16_t left operands
+ *@param [in]  src2      uint16_t values of fp16_t right operands
+ *@param [out] dst       uint16_t values of fp16_t results
+ *@param [in]  n         element count
+ *@param [in]  roundMode round mode, default is round to nearest
+ *@brief   Add, subtract or multiply arrays of fp16_t elementwise, every element is bit-exact
+ *         with fp16Add/fp16Sub/fp16Mul<roundMode>, overflow saturates to signed FP16_MAX
+ */
+void fp16AddN(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16SubN(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16MulN(const uint16_t *src1, const uint16_t *src2, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+/**
+ *@ingroup fp16_t array math method
+ *@param [in]  src       uint16_t values of fp16_t objects
+ *@param [out] dst       uint16_t values of fp16_t results, can be the same as src
+ *@param [in]  n         element count
+ *@param [in]  roundMode round mode, default is round to nearest
+ *@brief   Calculate exp, ln, log2 or log10 of every element by range reduction and minimax
+ *         polynomials in float lanes. Every element is the libm result in double rounded
+ *         once under roundMode: lanes whose error bound contains a rounding boundary of
+ *         fp16_t fall back to libm. ROUND_TO_NEAREST and ROUND_BY_TRUNCATED are bit-exact
+ *         with hf_exp/hf_ln/hf_log2/hf_log10 under the same g_RoundMode
+ */
+void fp16ExpN(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16LnN(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16Log2N(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16Log10N(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+/**
+ *@ingroup fp16_t array math method
+ *@param [in]  src       uint16_t values of fp16_t objects
+ *@param [out] sinDst    uint16_t values of fp16_t sines, can be the same as src
+ *@param [out] cosDst    uint16_t values of fp16_t cosines, can be the same as src
+ *@param [in]  n         element count
+ *@param [in]  roundMode round mode, default is round to nearest
+ *@brief   Calculate sin and/or cos of every element by Cody-Waite reduction and minimax
+ *         polynomials in AVX2/AVX512 float lanes, fp16SinCosN evaluates both from one
+ *         reduction. Lower SIMD levels and tails use libm.
+ *         Lanes whose error bound contains a rounding boundary fall back to libm, so every
+ *         element is the libm result rounded under roundMode, through float for sin as
+ *         hf_sin does. ROUND_TO_NEAREST and ROUND_BY_TRUNCATED are bit-exact with
+ *         hf_sin/hf_cos under the same g_RoundMode
+ */
+void fp16SinN(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16CosN(const uint16_t *src, uint16_t *dst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+void fp16SinCosN(const uint16_t *src, uint16_t *sinDst, uint16_t *cosDst, size_t n, fp16RoundMode_t roundMode = ROUND_TO_NEAREST);
+/**
+ *@ingroup fp16_t array math method
+ *@param [in]  src1 fp16_t left operands
+ *@param [in]  src2 fp16_t right operands
+ *@param [out] dst  fp16_t results, can be the same as src1 or src2
+ *@param [in]  n    element count
+ *@brief   Elementwise fp16_t operators, every element is the same as src1[i] op src2[i]
+ *         under g_RoundMode of the calling thread
+ */
+void hf_addN(const fp16_t *src1, const fp16_t *src2, fp16_t *dst, size_t n);
+void hf_subN(const fp16_t *src1, const fp16_t *src2, fp16_t *dst, size_t n);
+void hf_mulN(const fp16_t *src1, const fp16_t *src2, fp16_t *dst, size_t n);
+void hf_divN(const fp16_t *src1, const fp16_t *src2, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t array conversion method
+ *@param [in]  fixVal   signed 1.14.17 fixed-point values
+ *@param [in]  n        element count
+ *@param [in]  fpScale  fp16_t deq scale of all elements
+ *@param [out] ret      fp16_t results
+ *@brief   Dequantize an array, every element is the same as deq(fixVal[i], fpScale)
+ *         under g_RoundMode of the calling thread
+ */
+void deqN(const uint32_t *fixVal, size_t n, fp16_t fpScale, fp16_t *ret);
+/**
+ *@ingroup fp16_t array conversion method
+ *@param [in]  fixVal   signed 1.14.17 fixed-point values, row-major [n/channels][channels]
+ *@param [in]  n        element count
+ *@param [in]  fpScale  fp16_t deq scales of every channel
+ *@param [in]  channels channel count, element i uses fpScale[i % channels]
+ *@param [out] ret      fp16_t results
+ *@brief   Dequantize an array by channel, every element is the same as
+ *         deq(fixVal[i], fpScale[i % channels]) under g_RoundMode of the calling thread
+ */
+void deqN(const uint32_t *fixVal, size_t n, const fp16_t *fpScale, size_t channels, fp16_t *ret);
+
+#endif /*_FP16_ARRAY_H_*/
@@ -10,13 +10,97 @@
  */
 
 #include "fp16_math.h"
+#include "fp16_array.h"
+#ifndef FP16_NO_MATH_TABLE
+#include <stdio.h>
+#include <string.h>
+#include "fp16_table.h"
+#endif
 
-fp16_t hf_rcp(fp16_t fp){
+#ifndef FP16_NO_MATH_TABLE
+/**
+ *@ingroup fp16_t mathematics static method
+ *@brief   table entry of a unary method for fp16_t input index
+ */
+template <fp16_t (*calc)(fp16_t)> static void HfUnaryEntry(uint32_t index, void *out){
+    fp16_t fp;
+    fp.val = (uint16_t)index;
+    uint16_t val = calc(fp).val;
+    memcpy(out, &val, sizeof(val));
+}
+
+/**
+ *@ingroup fp16_t mathematics static method
+ *@brief   Get the table named name##suffix, see GetFp16Table
+ */
+static const uint16_t *GetUnaryTableOf(const char *name, const char *suffix, fp16TableCalc_t entry){
+    char tableName[32];
+    snprintf(tableName, sizeof(tableName), "%s%s", name, suffix);
+    return (const uint16_t *)GetFp16Table(tableName, sizeof(uint16_t), entry);
+}
+
+/**
+ *@ingroup fp16_t mathematics static method
+ *@brief   Get the table of calc, name##_rn is got on first use for ROUND_TO_NEAREST
+ *         and name##_rz for the other modes since fp16_t::operator= truncates under them
+ *@return  Return table of calc under current g_RoundMode
+ */
+template <fp16_t (*calc)(fp16_t)> static const uint16_t *GetUnaryTable(const char *name){
+    if (ROUND_TO_NEAREST == g_RoundMode){
+        static const uint16_t *nearest = GetUnaryTableOf(name, "_rn", HfUnaryEntry<calc>);
+        return nearest;
+    }
+    static const uint16_t *truncated = GetUnaryTableOf(name, "_rz", HfUnaryEntry<calc>);
+    return truncated;
+}
+#endif
+
+template <fp16_t (*calc)(fp16_t)> static fp16_t HfUnary(fp16_t fp, const char *name){
 #ifdef PRINT_INPUT_OVERFLOW_ERROR
     if (FP16_IS_INVALID(fp.val)){
         std::cout << "input fp16_t value is overflow\n";
     }
 #endif
+#ifdef FP16_NO_MATH_TABLE
+    (void)name;
+    return calc(fp);
+#else
+    fp16_t ret;
+    ret.val = GetUnaryTable<calc>(name)[fp.val];
+    return ret;
+#endif
+}
+
+template <fp16_t (*calc)(fp16_t)> static void HfUnaryN(const fp16_t *src, fp16_t *dst, size_t n, const char *name){
+#ifdef FP16_NO_MATH_TABLE
+    for (size_t i = 0; i < n; i++){
+        dst[i] = HfUnary<calc>(src[i], name);
+    }
+#else
+    const uint16_t *table = GetUnaryTable<calc>(name);
+    for (size_t i = 0; i < n; i++){
+#ifdef PRINT_INPUT_OVERFLOW_ERROR
+        if (FP16_IS_INVALID(src[i].val)){
+            std::cout << "input fp16_t value is overflow\n";
+        }
+#endif
+        dst[i].val = table[src[i].val];
+    }
+#endif
+}
+
+#ifdef FP16_NO_MATH_TABLE
+/**
+ *@ingroup fp16_t mathematics static method
+ *@brief   round mode of the array kernels that gives the result of fp16_t::operator=,
+ *         which rounds to nearest under ROUND_TO_NEAREST and truncates otherwise
+ */
+static fp16RoundMode_t MathRoundMode(){
+    return (ROUND_TO_NEAREST == g_RoundMode) ? ROUND_TO_NEAREST : ROUND_BY_TRUNCATED;
+}
+#endif
+
+static fp16_t HfRcpCalc(fp16_t fp){
     fp16_t ret;
     //Convert half precision float number to double 
     double dVal = fp;
@@ -27,12 +111,7 @@ fp16_t hf_rcp(fp16_t fp){
     return ret;
 }
 
-fp16_t hf_sqrt(fp16_t fp){
-#ifdef PRINT_INPUT_OVERFLOW_ERROR
-    if (FP16_IS_INVALID(fp.val)){
-        std::cout << "input fp16_t value is overflow\n";
-    }
-#endif
+static fp16_t HfSqrtCalc(fp16_t fp){
     fp16_t ret;
     //half precision float number to double 
     double dVal = fp;
@@ -43,12 +122,7 @@ fp16_t hf_sqrt(fp16_t fp){
     return ret;
 }
 
-fp16_t hf_rsqrt(fp16_t fp){
-#ifdef PRINT_INPUT_OVERFLOW_ERROR
-    if (FP16_IS_INVALID(fp.val)){
-        std::cout << "input fp16_t value is overflow\n";
-    }
-#endif
+static fp16_t HfRsqrtCalc(fp16_t fp){
     fp16_t ret;
     //Convert half precision float number to double 
     double dVal = fp;
@@ -59,12 +133,7 @@ fp16_t hf_rsqrt(fp16_t fp){
     return ret;
 }
 
-fp16_t hf_pow2(fp16_t fp){
-#ifdef PRINT_INPUT_OVERFLOW_ERROR
-    if (FP16_IS_INVALID(fp.val)){
-        std::cout << "input fp16_t value is overflow\n";
-    }
-#endif
+static fp16_t HfPow2Calc(fp16_t fp){
     fp16_t ret;
     //Convert half precision float number to double 
     double dVal = fp;
@@ -76,12 +145,7 @@ fp16_t hf_pow2(fp16_t fp){
     return ret;
 }
 
-fp16_t hf_pow10(fp16_t fp){
-#ifdef PRINT_INPUT_OVERFLOW_ERROR
-    if (FP16_IS_INVALID(fp.val)){
-        std::cout << "input fp16_t value is overflow\n";
-    }
-#endif
+static fp16_t HfPow10Calc(fp16_t fp){
     fp16_t ret;
     //Convert half precision float number to double 
     double dVal = fp;
@@ -93,12 +157,7 @@ fp16_t hf_pow10(fp16_t fp){
     return ret;
 }
 
-fp16_t hf_log2(fp16_t fp){
-#ifdef PRINT_INPUT_OVERFLOW_ERROR
-    if (FP16_IS_INVALID(fp.val)){
-        std::cout << "input fp16_t value is overflow\n";
-    }
-#endif
+static fp16_t HfLog2Calc(fp16_t fp){
     fp16_t ret;
     // Convert half precision float number to double
     double dVal = fp;
@@ -110,12 +169,7 @@ fp16_t hf_log2(fp16_t fp){
     return ret;
 }
 
-fp16_t hf_log10(fp16_t fp){
-#ifdef PRINT_INPUT_OVERFLOW_ERROR
-    if (FP16_IS_INVALID(fp.val)){
-        std::cout << "input fp16_t value is overflow\n";
-    }
-#endif
+static fp16_t HfLog10Calc(fp16_t fp){
     fp16_t ret;
     // Convert half precision float number to double
     double dVal = fp;
@@ -127,12 +181,7 @@ fp16_t hf_log10(fp16_t fp){
     return ret;
 }
 
-fp16_t hf_cos(fp16_t fp){
-#ifdef PRINT_INPUT_OVERFLOW_ERROR
-    if (FP16_IS_INVALID(fp.val)){
-        std::cout << "input fp16_t value is overflow\n";
-    }
-#endif
+static fp16_t HfCosCalc(fp16_t fp){
     fp16_t ret;
     // Convert half precision float number to double
     double dVal = fp;
@@ -144,12 +193,7 @@ fp16_t hf_cos(fp16_t fp){
     return ret;
 }
 
-fp16_t hf_sin(fp16_t fp){
-#ifdef PRINT_INPUT_OVERFLOW_ERROR
-    if (FP16_IS_INVALID(fp.val)){
-        std::cout << "input fp16_t value is overflow\n";
-    }
-#endif
+static fp16_t HfSinCalc(fp16_t fp){
     fp16_t ret;
     // Convert half precision float number to double
     double dVal = fp;
@@ -185,12 +229,7 @@ fp16_t hf_min(fp16_t fp1, fp16_t fp2){
     }
 }
 
-fp16_t hf_exp(fp16_t fp){
-#ifdef PRINT_INPUT_OVERFLOW_ERROR
-    if (FP16_IS_INVALID(fp.val)){
-        std::cout << "input fp16_t value is overflow\n";
-    }
-#endif
+static fp16_t HfExpCalc(fp16_t fp){
     fp16_t ret;
     //Convert half precision float number to double 
     double d_val = fp;
@@ -202,12 +241,7 @@ fp16_t hf_exp(fp16_t fp){
     return ret;
 }
 
-fp16_t hf_ln(fp16_t fp){
-#ifdef PRINT_INPUT_OVERFLOW_ERROR
-    if (FP16_IS_INVALID(fp.val)){
-        std::cout << "input fp16_t value is overflow\n";
-    }
-#endif
+static fp16_t HfLnCalc(fp16_t fp){
     fp16_t ret;
     // Convert half precision float number to double
     double d_val = fp;
@@ -218,3 +252,364 @@ fp16_t hf_ln(fp16_t fp){
 
     return ret;
 }
+
+/*********************************table lookup*********************************/
+fp16_t hf_rcp(fp16_t fp){
+    return HfUnary<HfRcpCalc>(fp, "hf_rcp");
+}
+
+void hf_rcpN(const fp16_t *src, fp16_t *dst, size_t n){
+    HfUnaryN<HfRcpCalc>(src, dst, n, "hf_rcp");
+}
+
+fp16_t hf_sqrt(fp16_t fp){
+    return HfUnary<HfSqrtCalc>(fp, "hf_sqrt");
+}
+
+void hf_sqrtN(const fp16_t *src, fp16_t *dst, size_t n){
+    HfUnaryN<HfSqrtCalc>(src, dst, n, "hf_sqrt");
+}
+
+fp16_t hf_rsqrt(fp16_t fp){
+    return HfUnary<HfRsqrtCalc>(fp, "hf_rsqrt");
+}
+
+void hf_rsqrtN(const fp16_t *src, fp16_t *dst, size_t n){
+    HfUnaryN<HfRsqrtCalc>(src, dst, n, "hf_rsqrt");
+}
+
+fp16_t hf_pow2(fp16_t fp){
+    return HfUnary<HfPow2Calc>(fp, "hf_pow2");
+}
+
+void hf_pow2N(const fp16_t *src, fp16_t *dst, size_t n){
+    HfUnaryN<HfPow2Calc>(src, dst, n, "hf_pow2");
+}
+
+fp16_t hf_pow10(fp16_t fp){
+    return HfUnary<HfPow10Calc>(fp, "hf_pow10");
+}
+
+void hf_pow10N(const fp16_t *src, fp16_t *dst, size_t n){
+    HfUnaryN<HfPow10Calc>(src, dst, n, "hf_pow10");
+}
+
+fp16_t hf_log2(fp16_t fp){
+    return HfUnary<HfLog2Calc>(fp, "hf_log2");
+}
+
+void hf_log2N(const fp16_t *src, fp16_t *dst, size_t n){
+#ifdef FP16_NO_MATH_TABLE
+    fp16Log2N(&src->val, &dst->val, n, MathRoundMode());
+#else
+    HfUnaryN<HfLog2Calc>(src, dst, n, "hf_log2");
+#endif
+}
+
+fp16_t hf_log10(fp16_t fp){
+    return HfUnary<HfLog10Calc>(fp, "hf_log10");
+}
+
+void hf_log10N(const fp16_t *src, fp16_t *dst, size_t n){
+#ifdef FP16_NO_MATH_TABLE
+    fp16Log10N(&src->val, &dst->val, n, MathRoundMode());
+#else
+    HfUnaryN<HfLog10Calc>(src, dst, n, "hf_log10");
+#endif
+}
+
+fp16_t hf_cos(fp16_t fp){
+    return HfUnary<HfCosCalc>(fp, "hf_cos");
+}
+
+void hf_cosN(const fp16_t *src, fp16_t *dst, size_t n){
+#ifdef FP16_NO_MATH_TABLE
+    fp16CosN(&src->val, &dst->val, n, MathRoundMode());
+#else
+    HfUnaryN<HfCosCalc>(src, dst, n, "hf_cos");
+#endif
+}
+
+fp16_t hf_sin(fp16_t fp){
+    return HfUnary<HfSinCalc>(fp, "hf_sin");
+}
+
+void hf_sinN(const fp16_t *src, fp16_t *dst, size_t n){
+#ifdef FP16_NO_MATH_TABLE
+    fp16SinN(&src->val, &dst->val, n, MathRoundMode());
+#else
+    HfUnaryN<HfSinCalc>(src, dst, n, "hf_sin");
+#endif
+}
+
+void hf_sincos(fp16_t fp, fp16_t *sinVal, fp16_t *cosVal){
+#ifdef FP16_NO_MATH_TABLE
+    fp16SinCosN(&fp.val, &sinVal->val, &cosVal->val, 1, MathRoundMode());
+#else
+    *sinVal = HfUnary<HfSinCalc>(fp, "hf_sin");
+    *cosVal = HfUnary<HfCosCalc>(fp, "hf_cos");
+#endif
+}
+
+void hf_sincosN(const fp16_t *src, fp16_t *sinDst, fp16_t *cosDst, size_t n){
+#ifdef FP16_NO_MATH_TABLE
+    fp16SinCosN(&src->val, &sinDst->val, &cosDst->val, n, MathRoundMode());
+#else
+    const uint16_t *sinTable = GetUnaryTable<HfSinCalc>("hf_sin");
+    const uint16_t *cosTable = GetUnaryTable<HfCosCalc>("hf_cos");
+    for (size_t i = 0; i < n; i++){
+        uint16_t val = src[i].val;//read before the stores since either result can be src
+#ifdef PRINT_INPUT_OVERFLOW_ERROR
+        if (FP16_IS_INVALID(val)){
+            std::cout << "input fp16_t value is overflow\n";
+        }
+#endif
+        sinDst[i].val = sinTable[val];
+        cosDst[i].val = cosTable[val];
+    }
+#endif
+}
+
+fp16_t hf_exp(fp16_t fp){
+    return HfUnary<HfExpCalc>(fp, "hf_exp");
+}
+
+void hf_expN(const fp16_t *src, fp16_t *dst, size_t n){
+#ifdef FP16_NO_MATH_TABLE
+    fp16ExpN(&src->val, &dst->val, n, MathRoundMode());
+#else
+    HfUnaryN<HfExpCalc>(src, dst, n, "hf_exp");
+#endif
+}
+
+fp16_t hf_ln(fp16_t fp){
+    return HfUnary<HfLnCalc>(fp, "hf_ln");
+}
+
+void hf_lnN(const fp16_t *src, fp16_t *dst, size_t n){
+#ifdef FP16_NO_MATH_TABLE
+    fp16LnN(&src->val, &dst->val, n, MathRoundMode());
+#else
+    HfUnaryN<HfLnCalc>(src, dst, n, "hf_ln");
+#endif
+}
+
+/**
+ *@ingroup fp16_t mathematics static method
+ *@param [in] a  double the result is close to, a fp16_t value for large inputs
+ *@param [in] c  complement of the result, calculated apart from a, it has the sign of a
+ *               and is only 0 when it underflows in double
+ *@brief   Round a-c to fp16_t once. The double a-c lands exactly on a fp16_t value when c
+ *         is below its ulp although the result is not that value, fp16_t::operator= keeps
+ *         the value under truncation then, so the result steps one toward zero if a-c is
+ *         below it in magnitude
+ *@return  Return fp16_t of a-c
+ */
+static fp16_t HfActRound(double a, double c){
+    fp16_t ret;
+    double dVal = a - c;
+    ret = dVal;/*lint !e524 */
+    if ((ROUND_TO_NEAREST != g_RoundMode) && ((double)ret == dVal) && ((ret.val & ~FP16_SIGN_MASK) != 0)){
+        // a-dVal is exact since dVal is close to a, the rest is the part lost by a-c
+        double lost = (a - dVal) - c;
+        if ((dVal == a) || ((dVal > 0) ? (lost < 0) : (lost > 0))){
+            ret.val--;
+        }
+    }
+    return ret;
+}
+
+static fp16_t HfSigmoidCalc(fp16_t fp){
+    fp16_t ret;
+    double dVal = fp;
+    if (dVal > 0){
+        // 1/(1+exp(-x)) = 1-exp(-x)/(1+exp(-x))
+        double e = std::exp(-dVal);
+        return HfActRound(1.0, e / (1.0 + e));
+    }
+    ret = 1.0 / (1.0 + std::exp(-dVal));/*lint !e524 */
+    return ret;
+}
+
+static fp16_t HfSigmoidComposedCalc(fp16_t fp){
+    fp16_t one = 1.0_h;
+    fp16_t negFp;
+    negFp.val = fp.val ^ FP16_SIGN_MASK;
+    return one / (one + hf_exp(negFp));
+}
+
+static fp16_t HfTanhCalc(fp16_t fp){
+    fp16_t ret;
+    double dVal = fp;
+    if (std::fabs(dVal) >= 1.0){
+        // tanh(x) = sign(x)*(1-2*exp(-2|x|)/(1+exp(-2|x|)))
+        double e = std::exp(-2.0 * std::fabs(dVal));
+        double c = 2.0 * e / (1.0 + e);
+        return (dVal > 0) ? HfActRound(1.0, c) : HfActRound(-1.0, -c);
+    }
+    ret = std::tanh(dVal);/*lint !e524 */
+    return ret;
+}
+
+static fp16_t HfTanhComposedCalc(fp16_t fp){
+    fp16_t one = 1.0_h;
+    fp16_t e = hf_exp(fp + fp);
+    return (e - one) / (e + one);
+}
+
+static fp16_t HfGeluCalc(fp16_t fp){
+    fp16_t ret;
+    double dVal = fp;
+    if (dVal > 0){
+        // 0.5*x*(1+erf(x/sqrt(2))) = x-0.5*x*erfc(x/sqrt(2))
+        return HfActRound(dVal, 0.5 * dVal * std::erfc(dVal * 0.70710678118654752));
+    }
+    // 0.5*x*(1+erf(x/sqrt(2))) without the cancellation of 1+erf for negative x
+    ret = 0.5 * dVal * std::erfc(-dVal * 0.70710678118654752);/*lint !e524 */
+    return ret;
+}
+
+static fp16_t HfGeluComposedCalc(fp16_t fp){
+    fp16_t erfVal;
+    double dVal = fp * 0.70710678118654752_h;
+    erfVal = std::erf(dVal);/*lint !e524 */
+    return (fp * (1.0_h + erfVal)) * 0.5_h;
+}
+
+static fp16_t HfGeluTanhCalc(fp16_t fp){
+    fp16_t ret;
+    double dVal = fp;
+    double u = 0.79788456080286536 * (dVal + 0.044715 * dVal * dVal * dVal);
+    if (dVal > 0){
+        // 0.5*x*(1+tanh(u)) = x-x*exp(-2u)/(1+exp(-2u))
+        double e = std::exp(-2.0 * u);
+        return HfActRound(dVal, dVal * e / (1.0 + e));
+    }
+    // 0.5*x*(1+tanh(u)) = x/(1+exp(-2u)) without the cancellation for negative x
+    ret = dVal / (1.0 + std::exp(-2.0 * u));/*lint !e524 */
+    return ret;
+}
+
+static fp16_t HfGeluTanhComposedCalc(fp16_t fp){
+    fp16_t inner = fp + 0.044715_h * (fp * fp * fp);
+    fp16_t t = HfTanhComposedCalc(0.79788456080286536_h * inner);
+    return (fp * (1.0_h + t)) * 0.5_h;
+}
+
+static fp16_t HfSiluCalc(fp16_t fp){
+    fp16_t ret;
+    double dVal = fp;
+    if (dVal > 0){
+        // x/(1+exp(-x)) = x-x*exp(-x)/(1+exp(-x))
+        double e = std::exp(-dVal);
+        return HfActRound(dVal, dVal * e / (1.0 + e));
+    }
+    ret = dVal / (1.0 + std::exp(-dVal));/*lint !e524 */
+    return ret;
+}
+
+static fp16_t HfSiluComposedCalc(fp16_t fp){
+    return fp * HfSigmoidComposedCalc(fp);
+}
+
+static fp16_t HfSoftplusCalc(fp16_t fp){
+    fp16_t ret;
+    double dVal = fp;
+    // ln(1+exp(x)) = x + ln(1+exp(-x)), exp of positive x may overflow in double
+    ret = (dVal > 0) ? (dVal + std::log1p(std::exp(-dVal))) : std::log1p(std::exp(dVal));/*lint !e524 */
+    return ret;
+}
+
+static fp16_t HfSoftplusComposedCalc(fp16_t fp){
+    return hf_ln(1.0_h + hf_exp(fp));
+}
+
+fp16_t hf_sigmoid(fp16_t fp, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        return HfUnary<HfSigmoidComposedCalc>(fp, "hf_sigmoid_c");
+    }
+    return HfUnary<HfSigmoidCalc>(fp, "hf_sigmoid");
+}
+
+void hf_sigmoidN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        HfUnaryN<HfSigmoidComposedCalc>(src, dst, n, "hf_sigmoid_c");
+        return;
+    }
+    HfUnaryN<HfSigmoidCalc>(src, dst, n, "hf_sigmoid");
+}
+
+fp16_t hf_tanh(fp16_t fp, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        return HfUnary<HfTanhComposedCalc>(fp, "hf_tanh_c");
+    }
+    return HfUnary<HfTanhCalc>(fp, "hf_tanh");
+}
+
+void hf_tanhN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        HfUnaryN<HfTanhComposedCalc>(src, dst, n, "hf_tanh_c");
+        return;
+    }
+    HfUnaryN<HfTanhCalc>(src, dst, n, "hf_tanh");
+}
+
+fp16_t hf_gelu(fp16_t fp, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        return HfUnary<HfGeluComposedCalc>(fp, "hf_gelu_c");
+    }
+    return HfUnary<HfGeluCalc>(fp, "hf_gelu");
+}
+
+void hf_geluN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        HfUnaryN<HfGeluComposedCalc>(src, dst, n, "hf_gelu_c");
+        return;
+    }
+    HfUnaryN<HfGeluCalc>(src, dst, n, "hf_gelu");
+}
+
+fp16_t hf_geluTanh(fp16_t fp, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        return HfUnary<HfGeluTanhComposedCalc>(fp, "hf_gelu_tanh_c");
+    }
+    return HfUnary<HfGeluTanhCalc>(fp, "hf_gelu_tanh");
+}
+
+void hf_geluTanhN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        HfUnaryN<HfGeluTanhComposedCalc>(src, dst, n, "hf_gelu_tanh_c");
+        return;
+    }
+    HfUnaryN<HfGeluTanhCalc>(src, dst, n, "hf_gelu_tanh");
+}
+
+fp16_t hf_silu(fp16_t fp, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        return HfUnary<HfSiluComposedCalc>(fp, "hf_silu_c");
+    }
+    return HfUnary<HfSiluCalc>(fp, "hf_silu");
+}
+
+void hf_siluN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        HfUnaryN<HfSiluComposedCalc>(src, dst, n, "hf_silu_c");
+        return;
+    }
+    HfUnaryN<HfSiluCalc>(src, dst, n, "hf_silu");
+}
+
+fp16_t hf_softplus(fp16_t fp, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        return HfUnary<HfSoftplusComposedCalc>(fp, "hf_softplus_c");
+    }
+    return HfUnary<HfSoftplusCalc>(fp, "hf_softplus");
+}
+
+void hf_softplusN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round){
+    if (ACT_ROUND_COMPOSED == round){
+        HfUnaryN<HfSoftplusComposedCalc>(src, dst, n, "hf_softplus_c");
+        return;
+    }
+    HfUnaryN<HfSoftplusCalc>(src, dst, n, "hf_softplus");
+}
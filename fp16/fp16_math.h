@@ -11,8 +11,18 @@
 #ifndef _FP16_MATH_H_
 #define _FP16_MATH_H_
 
+#include <stddef.h>
 #include "fp16_t.h"
 
+/**
+ *@ingroup table switch
+ *@brief   hf_rcp ~ hf_ln compute in double by libm on every call instead of reading a
+ *         65536 entries table (128KB) which is filled by the same computation on first use.
+ *         hf_expN, hf_lnN, hf_log2N, hf_log10N, hf_sinN, hf_cosN and hf_sincos(N) use the
+ *         float polynomial kernels of fp16_array.h then, which give the same results
+ */
+//#define FP16_NO_MATH_TABLE
+
 /**
  *@ingroup fp16_t mathematics method
  *@param [in] fp fp16_t object to be calculate
@@ -90,6 +100,14 @@ fp16_t hf_cos(fp16_t fp);
  *@return  Returns fp16_t sine of fp
  */
 fp16_t hf_sin(fp16_t fp);
+/**
+ *@ingroup fp16_t mathematics method
+ *@param [in]  fp     fp16_t object to be calculate
+ *@param [out] sinVal fp16_t sine of fp, the same as hf_sin
+ *@param [out] cosVal fp16_t cosine of fp, the same as hf_cos
+ *@brief   Calculate fp16_t sine and cosine of fp16_t in one call
+ */
+void hf_sincos(fp16_t fp, fp16_t *sinVal, fp16_t *cosVal);
 /**
  *@ingroup fp16_t mathematics method
  *@param [in] fp fp16_t object to be calculate
@@ -113,6 +131,227 @@ fp16_t hf_max(fp16_t fp1, fp16_t fp2);
  *@return  Returns minimum fp16_t of fp1 and fp2
  */
 fp16_t hf_min(fp16_t fp1, fp16_t fp2);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate reciprocal of every element, results are the same as hf_rcp
+ */
+void hf_rcpN(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate square root of every element, results are the same as hf_sqrt
+ */
+void hf_sqrtN(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate reciprocal square root of every element,
+ *         results are the same as hf_rsqrt
+ */
+void hf_rsqrtN(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate natural exponential of every element, results are the same as hf_exp
+ */
+void hf_expN(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate binary exponential of every element, results are the same as hf_pow2
+ */
+void hf_pow2N(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate decimal exponential of every element, results are the same as hf_pow10
+ */
+void hf_pow10N(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate natural logarithm of every element, results are the same as hf_ln
+ */
+void hf_lnN(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate binary logarithm of every element, results are the same as hf_log2
+ */
+void hf_log2N(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate decimal logarithm of every element, results are the same as hf_log10
+ */
+void hf_log10N(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate cosine of every element, results are the same as hf_cos
+ */
+void hf_cosN(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate sine of every element, results are the same as hf_sin
+ */
+void hf_sinN(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src    fp16_t objects to be calculate
+ *@param [out] sinDst fp16_t sines, can be the same as src
+ *@param [out] cosDst fp16_t cosines, can be the same as src
+ *@param [in]  n      element count
+ *@brief   Calculate sine and cosine of every element in one pass, results are the same
+ *         as hf_sin and hf_cos
+ */
+void hf_sincosN(const fp16_t *src, fp16_t *sinDst, fp16_t *cosDst, size_t n);
+
+/**
+ *@ingroup fp16_t enum
+ *@brief   rounding of the activation methods
+ */
+typedef enum tagFp16ActRound
+{
+    ACT_ROUND_SINGLE = 0,   /**< calculated in double and rounded to fp16_t once               */
+    ACT_ROUND_COMPOSED,     /**< rounded as composing hf_exp, hf_ln and fp16_t operators does,
+                                 every intermediate result is a fp16_t                        */
+    ACT_ROUND_RESERVED,
+} fp16ActRound_t;
+/**
+ *@ingroup fp16_t activation method
+ *@param [in] fp    fp16_t object to be calculate
+ *@param [in] round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate sigmoid of fp16_t, 1/(1+exp(-x)). ACT_ROUND_COMPOSED gives
+ *         one/(one+hf_exp(-x))
+ *@return  Returns fp16_t sigmoid of fp
+ */
+fp16_t hf_sigmoid(fp16_t fp, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation array method
+ *@param [in]  src   fp16_t objects to be calculate
+ *@param [out] dst   fp16_t results, can be the same as src
+ *@param [in]  n     element count
+ *@param [in]  round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate sigmoid of every element, results are the same as hf_sigmoid
+ */
+void hf_sigmoidN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation method
+ *@param [in] fp    fp16_t object to be calculate
+ *@param [in] round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate hyperbolic tangent of fp16_t, tanh(x). ACT_ROUND_COMPOSED gives
+ *         (e-one)/(e+one) with e = hf_exp(x+x)
+ *@return  Returns fp16_t hyperbolic tangent of fp
+ */
+fp16_t hf_tanh(fp16_t fp, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation array method
+ *@param [in]  src   fp16_t objects to be calculate
+ *@param [out] dst   fp16_t results, can be the same as src
+ *@param [in]  n     element count
+ *@param [in]  round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate hyperbolic tangent of every element, results are the same as hf_tanh
+ */
+void hf_tanhN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation method
+ *@param [in] fp    fp16_t object to be calculate
+ *@param [in] round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate GELU in erf form of fp16_t, 0.5*x*(1+erf(x/sqrt(2))).
+ *         ACT_ROUND_COMPOSED gives (x*(one+erf))*0.5 with erf of x*0.7071 rounded to
+ *         fp16_t as one op
+ *@return  Returns fp16_t GELU in erf form of fp
+ */
+fp16_t hf_gelu(fp16_t fp, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation array method
+ *@param [in]  src   fp16_t objects to be calculate
+ *@param [out] dst   fp16_t results, can be the same as src
+ *@param [in]  n     element count
+ *@param [in]  round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate GELU in erf form of every element, results are the same as hf_gelu
+ */
+void hf_geluN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation method
+ *@param [in] fp    fp16_t object to be calculate
+ *@param [in] round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate GELU in tanh form of fp16_t, 0.5*x*(1+tanh(0.79788*(x+0.044715*x^3))).
+ *         ACT_ROUND_COMPOSED gives (x*(one+t))*0.5 with t the composed hf_tanh of
+ *         0.79788*(x+0.044715*(x*x*x))
+ *@return  Returns fp16_t GELU in tanh form of fp
+ */
+fp16_t hf_geluTanh(fp16_t fp, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation array method
+ *@param [in]  src   fp16_t objects to be calculate
+ *@param [out] dst   fp16_t results, can be the same as src
+ *@param [in]  n     element count
+ *@param [in]  round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate GELU in tanh form of every element, results are the same as hf_geluTanh
+ */
+void hf_geluTanhN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation method
+ *@param [in] fp    fp16_t object to be calculate
+ *@param [in] round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate SiLU of fp16_t, x/(1+exp(-x)). ACT_ROUND_COMPOSED gives x*sigmoid(x)
+ *         with the composed sigmoid
+ *@return  Returns fp16_t SiLU of fp
+ */
+fp16_t hf_silu(fp16_t fp, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation array method
+ *@param [in]  src   fp16_t objects to be calculate
+ *@param [out] dst   fp16_t results, can be the same as src
+ *@param [in]  n     element count
+ *@param [in]  round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate SiLU of every element, results are the same as hf_silu
+ */
+void hf_siluN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation method
+ *@param [in] fp    fp16_t object to be calculate
+ *@param [in] round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate softplus of fp16_t, ln(1+exp(x)). ACT_ROUND_COMPOSED gives
+ *         hf_ln(one+hf_exp(x))
+ *@return  Returns fp16_t softplus of fp
+ */
+fp16_t hf_softplus(fp16_t fp, fp16ActRound_t round = ACT_ROUND_SINGLE);
+/**
+ *@ingroup fp16_t activation array method
+ *@param [in]  src   fp16_t objects to be calculate
+ *@param [out] dst   fp16_t results, can be the same as src
+ *@param [in]  n     element count
+ *@param [in]  round rounding, default is ACT_ROUND_SINGLE
+ *@brief   Calculate softplus of every element, results are the same as hf_softplus
+ */
+void hf_softplusN(const fp16_t *src, fp16_t *dst, size_t n, fp16ActRound_t round = ACT_ROUND_SINGLE);
 
 
 #endif /*_FP16_MATH_H_*/
@@ -0,0 +1,51 @@
+/**
+ * @file fp16_simd.cc
+ *
+ * Copyright(C), 2017 - 2018, Lxzh Tech. Co., Ltd. ALL RIGHTS RESERVED.
+ *
+ * @brief SIMD instruction set dispatch of Half precision float array methods
+ *
+ * @version 1.0
+ *
+ */
+#include "fp16_simd.h"
+
+/**
+ *@ingroup fp16_t simd global filed
+ *@brief   level limit set by SetFp16SimdLevel
+ */
+static volatile int g_SimdLevelLimit = SIMD_LEVEL_RESERVED;
+
+/**
+ *@ingroup fp16_t simd static method
+ *@brief   Detect the highest instruction set supported by the running cpu
+ *@return  Return instruction set level
+ */
+static fp16SimdLevel_t DetectSimdLevel(){
+#ifdef FP16_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx2") &&
+        __builtin_cpu_supports("fma")){
+        return SIMD_LEVEL_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")){
+        // F16C has no __builtin_cpu_supports name on older compilers, every AVX2 cpu has it
+        return SIMD_LEVEL_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")){
+        return SIMD_LEVEL_SSE2;
+    }
+#endif
+    return SIMD_LEVEL_SCALAR;
+}
+
+fp16SimdLevel_t GetFp16SimdLevel(){
+    static const fp16SimdLevel_t detected = DetectSimdLevel();
+    int limit = g_SimdLevelLimit;
+    return (limit < (int)detected) ? (fp16SimdLevel_t)limit : detected;
+}
+
+void SetFp16SimdLevel(fp16SimdLevel_t level){
+    g_SimdLevelLimit = level;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file fp16_simd.h
+ *
+ * Copyright(C), 2017 - 2018, Lxzh Tech. Co., Ltd. ALL RIGHTS RESERVED.
+ *
+ * @brief SIMD instruction set dispatch of Half precision float array methods
+ *
+ * @version 1.0
+ *
+ */
+#ifndef _FP16_SIMD_H_
+#define _FP16_SIMD_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ *@ingroup fp16 simd switch
+ *@brief   x86 SIMD code paths are built with gcc/clang target attributes,
+ *         other compilers and architectures only get the scalar path
+ */
+#if defined(__GNUC__) && (defined(__amd64__) || defined(__i386__)) && !defined(FP16_NO_SIMD)
+#define FP16_SIMD_X86
+#include <immintrin.h>
+#define FP16_TARGET_SSE2               __attribute__((target("sse2")))
+#define FP16_TARGET_AVX2               __attribute__((target("avx2,f16c,fma")))
+#define FP16_TARGET_AVX512             __attribute__((target("avx512f,avx512bw,avx512vl,avx2,f16c,fma")))
+//gcc fuses separate mul and add intrinsics into fma, kernels that repeat unfused scalar
+//float code bit-exactly turn it off, clang does not fuse across intrinsics
+#if defined(__clang__)
+#define FP16_NO_CONTRACT
+#else
+#define FP16_NO_CONTRACT               __attribute__((optimize("fp-contract=off")))
+#endif
+//avx512fintrin.h starts conversions from _mm512_undefined_*(), gcc reports it as uninitialized
+//in every inlined caller, AVX-512 kernels are put between these to keep -Wall output readable
+#if defined(__clang__)
+#define FP16_AVX512_BEGIN
+#define FP16_AVX512_END
+#else
+#define FP16_AVX512_BEGIN              _Pragma("GCC diagnostic push")                            \
+                                       _Pragma("GCC diagnostic ignored \"-Wuninitialized\"")     \
+                                       _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define FP16_AVX512_END                _Pragma("GCC diagnostic pop")
+#endif
+#endif
+
+/**
+ *@ingroup fp16_t enum
+ *@brief   instruction set used by array methods
+ */
+typedef enum tagFp16SimdLevel
+{
+    SIMD_LEVEL_SCALAR = 0,   /**< plain C++ loop                       */
+    SIMD_LEVEL_SSE2,         /**< SSE2                                 */
+    SIMD_LEVEL_AVX2,         /**< AVX2 with F16C and FMA               */
+    SIMD_LEVEL_AVX512,       /**< AVX-512 F/BW/VL                      */
+    SIMD_LEVEL_RESERVED,
+} fp16SimdLevel_t;
+
+/**
+ *@ingroup fp16_t simd method
+ *@brief   Get the instruction set used by array methods, detected from the
+ *         running cpu once and limited by SetFp16SimdLevel
+ *@return  Return instruction set level
+ */
+fp16SimdLevel_t GetFp16SimdLevel();
+/**
+ *@ingroup fp16_t simd method
+ *@param [in] level highest instruction set array methods are allowed to use
+ *@brief   Limit the instruction set of array methods, a level higher than the
+ *         running cpu supports is clamped to the detected one
+ */
+void SetFp16SimdLevel(fp16SimdLevel_t level);
+
+#endif /*_FP16_SIMD_H_*/
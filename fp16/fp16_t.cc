@@ -8,15 +8,23 @@
  * @version 1.0
  *
  */
+#ifndef _FP16_T_CC_
+#define _FP16_T_CC_
+
 #include "fp16_t.h"
+#include "fpe.h"
+#include <string.h>
+#ifdef FP16_DECODE_TABLE
+#include "fp16_table.h"
+#endif
 
 /**
  *@ingroup fp16_t global filed
- *@brief   round mode of last valid digital
+ *@brief   round mode of last valid digital, one per thread
  */
-fp16RoundMode_t g_RoundMode = ROUND_TO_NEAREST;
+FP16_INLINE thread_local fp16RoundMode_t g_RoundMode = ROUND_TO_NEAREST;
 
-void ExtractFP16(const uint16_t &val, uint16_t *s, int16_t *e, uint16_t *m){
+FP16_INLINE void ExtractFP16(const uint16_t &val, uint16_t *s, int16_t *e, uint16_t *m){
     //1.Extract
     *s = FP16_EXTRAC_SIGN(val);
     *e = FP16_EXTRAC_EXP(val);
@@ -28,13 +36,13 @@ void ExtractFP16(const uint16_t &val, uint16_t *s, int16_t *e, uint16_t *m){
     }
 }
 /**
- *@ingroup fp16_t static method
+ *@ingroup fp16_t public method
  *@param [in] man       truncated mantissa
  *@param [in] shift_out left shift bits based on ten bits
  *@brief   judge whether to add one to the result while converting fp16_t to other datatype
  *@return  Return true if add one, otherwise false
  */
-static bool IsRoundOne(uint64_t man, uint16_t trunc_len){
+FP16_INLINE bool IsRoundOne(uint64_t man, uint16_t trunc_len){
     uint64_t mask0 = 0x4;
     uint64_t mask1 = 0x2;
     uint64_t mask2 = 0x1;
@@ -61,7 +69,7 @@ static bool IsRoundOne(uint64_t man, uint16_t trunc_len){
  *@brief   judge whether to add one to the result while converting fp16_t to other datatype
  *@return  Return true if add one, otherwise false
  */
-static bool IsRoundOne(uint32_t sign, uint64_t man, uint16_t trunc_len, fp16RoundMode_t roundMode){
+FP16_STATIC bool IsRoundOne(uint32_t sign, uint64_t man, uint16_t trunc_len, fp16RoundMode_t roundMode){
     uint64_t mask0 = 0x4;
     uint64_t mask1 = 0x2;
     uint64_t mask2 = 0x1;
@@ -95,7 +103,7 @@ static bool IsRoundOne(uint32_t sign, uint64_t man, uint16_t trunc_len, fp16Roun
  *@brief   Get float mantissa of uint16_t value of fp16_t object
  *@return  Return float mantissa of fpVal which should be in [ 0, 1 )
  */
-static float fp16GetFMantissa(uint16_t fpVal){
+FP16_STATIC float fp16GetFMantissa(uint16_t fpVal){
     float ret = 0.0f, weight;
     uint16_t mantissa, bitmask;
 
@@ -109,7 +117,13 @@ static float fp16GetFMantissa(uint16_t fpVal){
     return ret;
 }
 
-float    fp16ToFloat(const uint16_t &fpVal){
+/**
+ *@ingroup fp16_t static method
+ *@param [in] fpVal uint16_t value of fp16_t object
+ *@brief   Convert fp16_t to float/fp32 by extracting exponent and mantissa
+ *@return  Return float/fp32 value of fpVal
+ */
+FP16_STATIC float Fp16ToFloatCalc(uint16_t fpVal){
     float ret;
 
     uint16_t hf_sign,hf_man;
@@ -134,12 +148,18 @@ float    fp16ToFloat(const uint16_t &fpVal){
         m_ret = m_ret << (FP32_MAN_LEN - FP16_MAN_LEN);
     }
     fVal = FP32_CONSTRUCTOR(s_ret, e_ret, m_ret);
-    ret = *((float *)&fVal);
+    memcpy(&ret, &fVal, sizeof(ret));
 
     return ret;
 }
 
-double   fp16ToDouble(const uint16_t &fpVal){
+/**
+ *@ingroup fp16_t static method
+ *@param [in] fpVal uint16_t value of fp16_t object
+ *@brief   Convert fp16_t to double/fp64 by extracting exponent and mantissa
+ *@return  Return double/fp64 value of fpVal
+ */
+FP16_STATIC double Fp16ToDoubleCalc(uint16_t fpVal){
     double ret;
 
     uint16_t hf_sign, hf_man;
@@ -164,12 +184,57 @@ double   fp16ToDouble(const uint16_t &fpVal){
         m_ret = m_ret << (FP64_MAN_LEN - FP16_MAN_LEN);
     }
     fVal = (s_ret << FP64_SIGN_INDEX) | (e_ret << FP64_MAN_LEN) | (m_ret);
-    ret = *((double *)&fVal);
+    memcpy(&ret, &fVal, sizeof(ret));
 
     return ret;
 }
 
-int8_t   fp16ToInt8(const uint16_t &fpVal){
+#ifdef FP16_DECODE_TABLE
+/**
+ *@ingroup fp16_t static method
+ *@brief   decode table entry of fp16_t value index, T support types: float/double
+ */
+template <typename T, T(*calc)(uint16_t)> FP16_STATIC void Fp16DecodeEntry(uint32_t index, void *out){
+    T val = calc((uint16_t)index);
+    memcpy(out, &val, sizeof(T));
+}
+/**
+ *@ingroup fp16_t static method
+ *@brief   Get float decode table, it is got once and thread-safely by the first caller
+ */
+FP16_STATIC const float *GetFloatDecodeTable(){
+    static const float *table = (const float *)GetFp16Table("fp16_to_float", sizeof(float),
+        Fp16DecodeEntry<float, Fp16ToFloatCalc>);
+    return table;
+}
+/**
+ *@ingroup fp16_t static method
+ *@brief   Get double decode table, it is got once and thread-safely by the first caller
+ */
+FP16_STATIC const double *GetDoubleDecodeTable(){
+    static const double *table = (const double *)GetFp16Table("fp16_to_double", sizeof(double),
+        Fp16DecodeEntry<double, Fp16ToDoubleCalc>);
+    return table;
+}
+#endif
+
+FP16_INLINE float    fp16ToFloat(const uint16_t &fpVal){
+#ifdef FP16_DECODE_TABLE
+    return GetFloatDecodeTable()[fpVal];
+#else
+    return Fp16ToFloatCalc(fpVal);
+#endif
+}
+
+FP16_INLINE double   fp16ToDouble(const uint16_t &fpVal){
+#ifdef FP16_DECODE_TABLE
+    return GetDoubleDecodeTable()[fpVal];
+#else
+    return Fp16ToDoubleCalc(fpVal);
+#endif
+}
+
+FP16_INLINE int8_t   fp16ToInt8(const uint16_t &fpVal){
     int8_t ret;
     uint8_t ret_v;
     uint8_t s_ret, m_ret = 0;
@@ -239,7 +304,7 @@ int8_t   fp16ToInt8(const uint16_t &fpVal){
     return ret;
 }
 
-uint8_t  fp16ToUInt8(const uint16_t &fpVal){
+FP16_INLINE uint8_t  fp16ToUInt8(const uint16_t &fpVal){
     uint8_t ret;
     uint8_t s_ret, m_ret = 0;
     uint16_t hf_e, hf_m;
@@ -297,7 +362,7 @@ uint8_t  fp16ToUInt8(const uint16_t &fpVal){
     return ret;
 }
 
-int16_t  fp16ToInt16(const uint16_t &fpVal){
+FP16_INLINE int16_t  fp16ToInt16(const uint16_t &fpVal){
     int16_t ret;
     uint16_t ret_v;
     uint16_t s_ret, m_ret = 0;
@@ -368,7 +433,7 @@ int16_t  fp16ToInt16(const uint16_t &fpVal){
     return ret;
 }
 
-uint16_t fp16ToUInt16(const uint16_t &fpVal){
+FP16_INLINE uint16_t fp16ToUInt16(const uint16_t &fpVal){
     uint16_t ret;
     uint16_t s_ret, m_ret = 0;
     uint16_t hf_e, hf_m;
@@ -425,7 +490,7 @@ uint16_t fp16ToUInt16(const uint16_t &fpVal){
     return ret;
 }
 
-int32_t  fp16ToInt32(const uint16_t &fpVal, fp16RoundMode_t roundMode){
+FP16_INLINE int32_t  fp16ToInt32(const uint16_t &fpVal, fp16RoundMode_t roundMode){
     int32_t ret;
     uint32_t ret_v;
     uint32_t s_ret, m_ret;
@@ -473,7 +538,7 @@ int32_t  fp16ToInt32(const uint16_t &fpVal, fp16RoundMode_t roundMode){
     return ret;
 }
 
-uint32_t fp16ToUInt32(const uint16_t &fpVal){
+FP16_INLINE uint32_t fp16ToUInt32(const uint16_t &fpVal){
     uint32_t ret;
     uint32_t s_ret, m_ret;
     uint16_t hf_e, hf_m;
@@ -521,7 +586,7 @@ uint32_t fp16ToUInt32(const uint16_t &fpVal){
     return ret;
 }
 
-fp16_t deq(const uint32_t &fixVal, fp16_t fpScale){
+FP16_INLINE fp16_t deq(const uint32_t &fixVal, fp16_t fpScale){
     uint16_t s_x;
     uint32_t inte, dcml;
     /***************signed fixed-point number**************/
@@ -573,6 +638,15 @@ fp16_t deq(const uint32_t &fixVal, fp16_t fpScale){
     return ret;
 }
 
+/**
+ *@ingroup fp16_t static method
+ *@param [in] sign sign of an inexact result
+ *@brief   judge whether a directed roundMode adds one to an inexact truncated mantissa
+ *@return  Return true if add one, otherwise false
+ */
+template <fp16RoundMode_t roundMode> FP16_STATIC bool IsRoundAway(uint16_t sign){
+    return ((ROUND_TO_CEILING == roundMode) && (sign == 0)) || ((ROUND_TO_FLOOR == roundMode) && (sign != 0));
+}
 /**
  *@ingroup fp16_t math operator
  *@param [in] v1 left operator value of fp16_t object
@@ -580,7 +654,7 @@ fp16_t deq(const uint32_t &fixVal, fp16_t fpScale){
  *@brief   Performing fp16_t addition
  *@return  Return fp16_t result of adding this and fp
  */
- static uint16_t fp16Add(uint16_t v1, uint16_t v2){
+template <fp16RoundMode_t roundMode> uint16_t fp16Add(uint16_t v1, uint16_t v2){
 #ifdef PRINT_INPUT_OVERFLOW_ERROR
     if (FP16_IS_INVALID(v1) || FP16_IS_INVALID(v2)){
         std::cout << "input fp16_t value is overflow\n";
@@ -590,87 +664,56 @@ fp16_t deq(const uint32_t &fixVal, fp16_t fpScale){
     uint16_t ret;
     uint16_t s_a, s_b;
     int16_t e_a, e_b;
-    uint32_t m_a, m_b;
     uint16_t s_ret, m_ret;
     int16_t e_ret;
     uint16_t ma_tmp, mb_tmp;
 
-    uint16_t shift_out = 0;
     //1.Extract
     ExtractFP16(v1, &s_a, &e_a, &ma_tmp);
     ExtractFP16(v2, &s_b, &e_b, &mb_tmp);
-    m_a = ma_tmp;
-    m_b = mb_tmp;
-
-    uint16_t sum;
-    if (s_a != s_b){
-        ReverseMan(s_a > 0, &m_a);
-        ReverseMan(s_b > 0, &m_b);
-        sum = (uint16_t)GetManSum(e_a, m_a, e_b, m_b);
-        s_ret = (sum&FP16_SIGN_MASK) >> FP16_SIGN_INDEX;
-        ReverseMan(s_ret > 0, &m_a);
-        ReverseMan(s_ret > 0, &m_b);
-    }
-    else{
-        sum = (uint16_t)GetManSum(e_a, m_a, e_b, m_b);
-        s_ret = s_a;
-    }
-
-    if (sum == 0){
-        shift_out = 3;
-        m_a = m_a << shift_out;
-        m_b = m_b << shift_out;
-    }
-
-    uint32_t m_trunc = 0;
-    int16_t e_tmp = 0;
-
-    e_ret = std::max(e_a, e_b);
-    e_tmp = std::abs(e_a - e_b);
-    if (e_a > e_b){
-        m_trunc = (m_b << (32 - e_tmp));
-        m_b = RightShift(m_b, e_tmp);
-    }
-    else if (e_a < e_b){
-        m_trunc = (m_a << (32 - e_tmp));
-        m_a = RightShift(m_a, e_tmp);
-    }
-    //calculate mantissa
-    m_ret = (uint16_t)(m_a + m_b);
-
-    //if (m_ret){
-    uint16_t m_min = FP16_MAN_HIDE_BIT << shift_out;
-    uint16_t m_max = m_min << 1;
-    //Denormal
-    while (m_ret<m_min && e_ret>0){//the value of m_ret should not be smaller than 2^23
-        m_ret = m_ret << 1;
-        m_ret += (FP32_SIGN_MASK&m_trunc) >> FP32_SIGN_INDEX;
-        m_trunc = m_trunc << 1;
-        e_ret = e_ret - 1;
-    }
-    while (m_ret >= m_max){//the value of m_ret should be smaller than 2^24
-        m_trunc = m_trunc >> 1;
-        m_trunc = m_trunc | (FP32_SIGN_MASK*(m_ret & 1));
-        m_ret = m_ret >> 1;
-        e_ret = e_ret + 1;
-    }
 
+    //2.Align: signed sum in a 32.32 fixed point window, the low word keeps the shifted out bits exactly
+    bool b_a_high = (e_a >= e_b);
+    int16_t e_tmp = b_a_high ? (e_a - e_b) : (e_b - e_a);//at most 30, nothing is lost
+    int64_t m_a = s_a ? -(int64_t)ma_tmp : (int64_t)ma_tmp;
+    int64_t m_b = s_b ? -(int64_t)mb_tmp : (int64_t)mb_tmp;
+    int64_t m_high = b_a_high ? m_a : m_b;
+    int64_t m_low = b_a_high ? m_b : m_a;
+    int64_t m_sum = m_high*((int64_t)1 << 32) + m_low*((int64_t)1 << (32 - e_tmp));
+    s_ret = (s_a == s_b) ? s_a : (uint16_t)(m_sum < 0);
+    uint64_t m_win = (uint64_t)(m_sum < 0 ? -m_sum : m_sum);
+    e_ret = Max16(e_a, e_b);
+
+    //integer part cancelled: keep 3 more bits
+    uint16_t shift_out = ((m_win >> 32) == 0) ? 3 : 0;
+    m_win = m_win << shift_out;
+
+    //3.Normalize: integer part of the window is [2^(10+shift_out), 2^(11+shift_out)), denormal stops at e_ret 0
+    int16_t norm_len = 32 + FP16_MAN_LEN + 1 + shift_out;
+    int16_t win_len = 64 - Clz64(m_win);
+    int16_t shift_left = Min16(Max16(norm_len - win_len, 0), e_ret);
+    int16_t shift_right = Max16(win_len - norm_len, 0);
+    m_win = (m_win << shift_left) >> shift_right;
+    e_ret = e_ret - shift_left + shift_right;
+    m_ret = (uint16_t)(m_win >> 32);
+    uint32_t m_trunc = (uint32_t)m_win;
+
+    //4.Round
     bool b_last_bit = ((m_ret & 1) > 0);
-    bool b_trunc_high = 0;
-    bool b_trunc_left = 0;
-    b_trunc_high = (ROUND_TO_NEAREST == g_RoundMode) && ((m_trunc&FP32_SIGN_MASK) > 0);
-    b_trunc_left = (ROUND_TO_NEAREST == g_RoundMode) && ((m_trunc&FP32_ABS_MAX) > 0);
+    bool b_trunc_high = (ROUND_TO_NEAREST == roundMode) && ((m_trunc&FP32_SIGN_MASK) > 0);
+    bool b_trunc_left = (ROUND_TO_NEAREST == roundMode) && ((m_trunc&FP32_ABS_MAX) > 0);
+    bool b_inexact = ((m_ret & ((1u << shift_out) - 1)) > 0) || (m_trunc > 0);
     m_ret = ManRoundToNearest(b_last_bit, b_trunc_high, b_trunc_left, m_ret, shift_out);
-    while (m_ret >= m_max){
-        m_ret = m_ret >> 1;
-        e_ret = e_ret + 1;
-    }
-    if (e_ret >= FP16_MAX_EXP){
-        e_ret = FP16_MAX_EXP-1;
-        m_ret = FP16_MAX_MAN;
-    } else if (e_ret == 0 && m_ret <= m_max){
-        m_ret = m_ret >> 1;
-    }
+    m_ret = m_ret + ((b_inexact && IsRoundAway<roundMode>(s_ret)) ? 1 : 0);
+    uint16_t m_max = FP16_MAN_HIDE_BIT << (shift_out + 1);
+    uint16_t carry = (m_ret >= m_max);
+    m_ret = m_ret >> carry;
+    e_ret = e_ret + carry;
+
+    //5.Overflow saturates to FP16_MAX, e_ret 0 means the window was shifted one bit too far
+    bool b_overflow = (e_ret >= FP16_MAX_EXP);
+    m_ret = b_overflow ? (uint16_t)FP16_MAX_MAN : ((e_ret == 0 && m_ret <= m_max) ? (m_ret >> 1) : m_ret);
+    e_ret = b_overflow ? (int16_t)(FP16_MAX_EXP - 1) : e_ret;
     ret = FP16_CONSTRUCTOR(s_ret, e_ret, m_ret);
     return ret;
 }
@@ -681,7 +724,7 @@ fp16_t deq(const uint32_t &fixVal, fp16_t fpScale){
     *@brief   Performing fp16_t subtraction
     *@return  Return fp16_t result of subtraction fp from this
     */
-static uint16_t fp16Sub(uint16_t v1, uint16_t v2){
+template <fp16RoundMode_t roundMode> uint16_t fp16Sub(uint16_t v1, uint16_t v2){
 #ifdef PRINT_INPUT_OVERFLOW_ERROR
     if (FP16_IS_INVALID(v1) || FP16_IS_INVALID(v2)){
         std::cout << "input fp16_t value is overflow\n";
@@ -694,7 +737,7 @@ static uint16_t fp16Sub(uint16_t v1, uint16_t v2){
     //Reverse
     tmp = ((~(v2))&FP16_SIGN_MASK) | (v2&FP16_ABS_MAX);
 
-    ret = fp16Add(v1, tmp);
+    ret = fp16Add<roundMode>(v1, tmp);
 
     return ret;
 }
@@ -705,7 +748,7 @@ static uint16_t fp16Sub(uint16_t v1, uint16_t v2){
     *@brief   Performing fp16_t multiplication
     *@return  Return fp16_t result of multiplying this and fp
     */
-static uint16_t fp16Mul(uint16_t v1, uint16_t v2){
+template <fp16RoundMode_t roundMode> uint16_t fp16Mul(uint16_t v1, uint16_t v2){
 #ifdef PRINT_INPUT_OVERFLOW_ERROR
     if (FP16_IS_INVALID(v1) || FP16_IS_INVALID(v2)){
         std::cout << "input fp16_t value is overflow\n";
@@ -718,7 +761,6 @@ static uint16_t fp16Mul(uint16_t v1, uint16_t v2){
     uint16_t s_ret, m_ret;
     int16_t e_ret;
     uint32_t mul_m;
-    uint16_t right_shift = 0;
     uint16_t ma_tmp, mb_tmp;
     //1.Extract
     ExtractFP16(v1, &s_a, &e_a, &ma_tmp);
@@ -727,41 +769,37 @@ static uint16_t fp16Mul(uint16_t v1, uint16_t v2){
     m_b = mb_tmp;
 
     e_ret = e_a + e_b - FP16_EXP_BIAS - 10;
-    mul_m = m_a*m_b;
+    mul_m = m_a*m_b;//at most 22 bits
     s_ret = s_a^s_b;
 
-    uint32_t m_min = FP16_MAN_HIDE_BIT;
-    uint32_t m_max = m_min << 1;
-    uint32_t m_trunc = 0;
-    //the value of m_ret should not be smaller than 2^23
-    while (mul_m<m_min&&e_ret>1){
-        mul_m = mul_m << 1;
-        e_ret = e_ret - 1;
-    }
-    while (mul_m >= m_max || e_ret < 1){
-        m_trunc = m_trunc >> 1;
-        m_trunc = m_trunc | (FP32_SIGN_MASK*(mul_m & 1));
-        mul_m = mul_m >> 1;
-        e_ret = e_ret + 1;
-    }
+    //2.Normalize: mul_m is [2^10, 2^11) with e_ret >= 1, otherwise denormal
+    int16_t man_len = 32 - Clz32(mul_m);
+    int16_t shift_left = (mul_m == 0) ? e_ret : (FP16_MAN_LEN + 1 - man_len);
+    shift_left = Min16(Max16(shift_left, 0), Max16(e_ret - 1, 0));
+    mul_m = mul_m << shift_left;
+    e_ret = e_ret - shift_left;
+    man_len = man_len + shift_left;
+    int16_t shift_right = Max16(Max16(man_len - FP16_MAN_LEN - 1, 1 - e_ret), 0);//at most 24
+    e_ret = e_ret + shift_right;
+
+    //3.Round: keep 2 extra bits for guard and sticky
+    uint32_t m_tmp = Shrsticky32(mul_m << 2, shift_right);
+    mul_m = m_tmp >> 2;
     bool b_last_bit = ((mul_m & 1) > 0);
-    bool b_trunc_high = 0;
-    bool b_trunc_left = 0;
-    b_trunc_high = (ROUND_TO_NEAREST == g_RoundMode) && ((m_trunc&FP32_SIGN_MASK) > 0);
-    b_trunc_left = (ROUND_TO_NEAREST == g_RoundMode) && ((m_trunc&FP32_ABS_MAX) > 0);
+    bool b_trunc_high = (ROUND_TO_NEAREST == roundMode) && ((m_tmp & 2) > 0);
+    bool b_trunc_left = (ROUND_TO_NEAREST == roundMode) && ((m_tmp & 1) > 0);
+    bool b_inexact = ((m_tmp & 3) > 0);
     mul_m = ManRoundToNearest(b_last_bit, b_trunc_high, b_trunc_left, mul_m);
-
-    while (mul_m >= m_max || e_ret < 0){
-        mul_m = mul_m >> 1;
-        e_ret = e_ret + 1;
-    }
-    if (e_ret >= FP16_MAX_EXP){
-        e_ret = FP16_MAX_EXP - 1;
-        mul_m = FP16_MAX_MAN;
-    }
-    if (e_ret == 1 && mul_m < FP16_MAN_HIDE_BIT){
-        e_ret = 0;
-    }
+    mul_m = mul_m + ((b_inexact && IsRoundAway<roundMode>(s_ret)) ? 1 : 0);
+    uint32_t carry = (mul_m >= (FP16_MAN_HIDE_BIT << 1));
+    mul_m = mul_m >> carry;
+    e_ret = e_ret + carry;
+
+    //4.Overflow saturates to FP16_MAX
+    bool b_overflow = (e_ret >= FP16_MAX_EXP);
+    mul_m = b_overflow ? (uint32_t)FP16_MAX_MAN : mul_m;
+    e_ret = b_overflow ? (int16_t)(FP16_MAX_EXP - 1) : e_ret;
+    e_ret = (e_ret == 1 && mul_m < FP16_MAN_HIDE_BIT) ? 0 : e_ret;
     m_ret = (uint16_t)mul_m;
     uint16_t ret = FP16_CONSTRUCTOR(s_ret, e_ret, m_ret);
     return ret;
@@ -773,110 +811,86 @@ static uint16_t fp16Mul(uint16_t v1, uint16_t v2){
     *@brief   Performing fp16_t division
     *@return  Return fp16_t result of division this by fp
     */
-static uint16_t fp16Div(uint16_t v1, uint16_t v2){
+template <fp16RoundMode_t roundMode> uint16_t fp16Div(uint16_t v1, uint16_t v2){
 #ifdef PRINT_INPUT_OVERFLOW_ERROR
     if (FP16_IS_INVALID(v1) || FP16_IS_INVALID(v2)){
         std::cout << "input fp16_t value is overflow\n";
     }
 #endif
 
-    uint16_t ret;
-    if (FP16_IS_ZERO(v2)){//result is inf
-        //throw "fp16_t division by zero.";
-        uint16_t s_a, s_b;
-        uint16_t s_ret;
-        s_a = FP16_EXTRAC_SIGN(v1);
-        s_b = FP16_EXTRAC_SIGN(v2);
-        s_ret = s_a^s_b;
-        ret = FP16_CONSTRUCTOR(s_ret, FP16_MAX_EXP-1, FP16_MAX_MAN);
-    }
-    else if (FP16_IS_ZERO(v1)){
-        ret = 0u;
-    }
-    else{
-        uint16_t s_a, s_b;
-        int16_t e_a, e_b;
-        uint64_t m_a, m_b;
-        float m_div;
-        uint16_t ma_tmp, mb_tmp;
-        //1.Extract
-        ExtractFP16(v1, &s_a, &e_a, &ma_tmp);
-        ExtractFP16(v2, &s_b, &e_b, &mb_tmp);
-        m_a = ma_tmp;
-        m_b = mb_tmp;
-
-        uint64_t m_tmp;
-        if (e_a > e_b){
-            m_tmp = m_a;
-            uint16_t tmp;
-            tmp = e_a - e_b;
-            for (int i = 0; i < tmp; i++){
-                m_tmp = m_tmp << 1;
-                //e_a = e_a - 1;
-            }
-            m_a = m_tmp;
-        }
-        else if (e_a < e_b){
-            m_tmp = m_b;
-            uint16_t tmp = e_b - e_a;
-            for (int i = 0; i < tmp; i++){
-                m_tmp = m_tmp << 1;
-                //e_b = e_b - 1;
-            }
-            m_b = m_tmp;
-        }
-        m_div = (float)(m_a*1.0f / m_b);
-        fp16_t fp_div;
-        fp_div = m_div;
-        ret = fp_div.val;
-        if (s_a != s_b){
-            ret |= FP16_SIGN_MASK;
-        }
-    }
+    int flags = 0;
+    uint16_t ret = fp16_div(v1, v2, roundMode, &flags);
     return ret;
 }
 
+#ifndef FP16_HEADER_ONLY
+template uint16_t fp16Add<ROUND_TO_NEAREST>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Add<ROUND_TO_CEILING>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Add<ROUND_TO_FLOOR>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Add<ROUND_BY_TRUNCATED>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Sub<ROUND_TO_NEAREST>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Sub<ROUND_TO_CEILING>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Sub<ROUND_TO_FLOOR>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Sub<ROUND_BY_TRUNCATED>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Mul<ROUND_TO_NEAREST>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Mul<ROUND_TO_CEILING>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Mul<ROUND_TO_FLOOR>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Mul<ROUND_BY_TRUNCATED>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Div<ROUND_TO_NEAREST>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Div<ROUND_TO_CEILING>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Div<ROUND_TO_FLOOR>(uint16_t v1, uint16_t v2);
+template uint16_t fp16Div<ROUND_BY_TRUNCATED>(uint16_t v1, uint16_t v2);
+#endif
+
+/**
+ *@ingroup fp16_t math operator
+ *@brief   call func under g_RoundMode of this thread, only ROUND_TO_NEAREST rounds and
+ *         the other modes are truncated as IsRoundOne does
+ */
+#define FP16_OPERATOR_CALL(func, v1, v2) ((ROUND_TO_NEAREST == g_RoundMode) ? \
+    func<ROUND_TO_NEAREST>(v1, v2) : func<ROUND_BY_TRUNCATED>(v1, v2))
+
 //operate
-fp16_t fp16_t::operator+(const fp16_t fp){
-    uint16_t retVal = fp16Add(val, fp.val);
+FP16_INLINE fp16_t fp16_t::operator+(const fp16_t fp){
+    uint16_t retVal = FP16_OPERATOR_CALL(fp16Add, val, fp.val);
     fp16_t ret(retVal);
     return ret;
 }
-fp16_t fp16_t::operator-(const fp16_t fp){
-    uint16_t retVal = fp16Sub(val, fp.val);
+FP16_INLINE fp16_t fp16_t::operator-(const fp16_t fp){
+    uint16_t retVal = FP16_OPERATOR_CALL(fp16Sub, val, fp.val);
     fp16_t ret(retVal);
     return ret;
 }
-fp16_t fp16_t::operator*(const fp16_t fp){
-    uint16_t retVal = fp16Mul(val, fp.val);
+FP16_INLINE fp16_t fp16_t::operator*(const fp16_t fp){
+    uint16_t retVal = FP16_OPERATOR_CALL(fp16Mul, val, fp.val);
     fp16_t ret(retVal);
     return ret;
 }
-fp16_t fp16_t::operator/(const fp16_t fp){
-    uint16_t retVal = fp16Div(val, fp.val);
+FP16_INLINE fp16_t fp16_t::operator/(const fp16_t fp){
+    uint16_t retVal = FP16_OPERATOR_CALL(fp16Div, val, fp.val);
     fp16_t ret(retVal);
     return ret;
 }
 
-fp16_t fp16_t::operator+=(const fp16_t fp){
-    val = fp16Add(val, fp.val);
+FP16_INLINE fp16_t fp16_t::operator+=(const fp16_t fp){
+    val = FP16_OPERATOR_CALL(fp16Add, val, fp.val);
     return *this;
 }
-fp16_t fp16_t::operator-=(const fp16_t fp){
-    val = fp16Sub(val, fp.val);
+FP16_INLINE fp16_t fp16_t::operator-=(const fp16_t fp){
+    val = FP16_OPERATOR_CALL(fp16Sub, val, fp.val);
     return *this;
 }
-fp16_t fp16_t::operator*=(const fp16_t fp){
-    val = fp16Mul(val, fp.val);
+FP16_INLINE fp16_t fp16_t::operator*=(const fp16_t fp){
+    val = FP16_OPERATOR_CALL(fp16Mul, val, fp.val);
     return *this;
 }
-fp16_t fp16_t::operator/=(const fp16_t fp){
-    val = fp16Div(val, fp.val);
+FP16_INLINE fp16_t fp16_t::operator/=(const fp16_t fp){
+    val = FP16_OPERATOR_CALL(fp16Div, val, fp.val);
     return *this;
 }
 
 //compare
-bool fp16_t::operator==(const fp16_t &fp) const {
+FP16_INLINE bool fp16_t::operator==(const fp16_t &fp) const {
     bool result;
     if (FP16_IS_ZERO(val) && FP16_IS_ZERO(fp.val)){
         result = true;
@@ -886,7 +900,7 @@ bool fp16_t::operator==(const fp16_t &fp) const {
     }
     return result;
 }
-bool fp16_t::operator!=(const fp16_t &fp) const {
+FP16_INLINE bool fp16_t::operator!=(const fp16_t &fp) const {
     bool result;
     if (FP16_IS_ZERO(val) && FP16_IS_ZERO(fp.val)){
         result = false;
@@ -896,7 +910,7 @@ bool fp16_t::operator!=(const fp16_t &fp) const {
     }
     return result;
 }
-bool fp16_t::operator> (const fp16_t &fp) const {
+FP16_INLINE bool fp16_t::operator> (const fp16_t &fp) const {
     uint16_t s_a, s_b;
     uint16_t e_a, e_b;
     uint16_t m_a, m_b;
@@ -943,7 +957,7 @@ bool fp16_t::operator> (const fp16_t &fp) const {
 
     return result;
 }
-bool fp16_t::operator>=(const fp16_t &fp) const {
+FP16_INLINE bool fp16_t::operator>=(const fp16_t &fp) const {
     bool result;
     if ((*this) > fp){
         result = true;
@@ -957,7 +971,7 @@ bool fp16_t::operator>=(const fp16_t &fp) const {
 
     return result;
 }
-bool fp16_t::operator< (const fp16_t &fp) const {
+FP16_INLINE bool fp16_t::operator< (const fp16_t &fp) const {
     bool result;
     if ((*this) >= fp){
         result = false;
@@ -968,7 +982,7 @@ bool fp16_t::operator< (const fp16_t &fp) const {
 
     return result;
 }
-bool fp16_t::operator<=(const fp16_t &fp) const {
+FP16_INLINE bool fp16_t::operator<=(const fp16_t &fp) const {
     bool result;
     if ((*this) > fp){
         result = false;
@@ -982,17 +996,18 @@ bool fp16_t::operator<=(const fp16_t &fp) const {
 
 
 //evaluation
-fp16_t& fp16_t::operator=(const fp16_t   &fp){
+FP16_INLINE fp16_t& fp16_t::operator=(const fp16_t   &fp){
     if (this == &fp){
         return *this;
     }
     val = fp.val;
     return *this;
 }
-fp16_t& fp16_t::operator=(const float    &fVal){
+FP16_INLINE fp16_t& fp16_t::operator=(const float    &fVal){
     uint16_t s_ret, e_ret, m_ret;
     uint32_t e_f, m_f;
-    uint32_t ui32_v = *((uint32_t *)&fVal);//1:8:23bit sign:exp:man
+    uint32_t ui32_v;//1:8:23bit sign:exp:man
+    memcpy(&ui32_v, &fVal, sizeof(ui32_v));
     uint32_t m_len_delta;
 
     s_ret = (uint16_t)((ui32_v & FP32_SIGN_MASK) >> FP32_SIGN_INDEX);//4Byte->2Byte
@@ -1018,8 +1033,11 @@ fp16_t& fp16_t::operator=(const float    &fVal){
             if (needRound){
                 m_ret++;
             }
+            if (m_ret & FP16_MAN_HIDE_BIT){//rounded up to the minimum normal value
+                e_ret = 1;
+            }
         }
-        else if (e_f == 0x66 && m_f > 0){//0x66:102 Denormal 0<f_v<min(Denormal)
+        else if (e_f == 0x66 && m_f > 0 && ROUND_TO_NEAREST == g_RoundMode){//above half of the minimum denormal
             m_ret = 1;
         }
         else{
@@ -1038,6 +1056,10 @@ fp16_t& fp16_t::operator=(const float    &fVal){
             e_ret++;
         }
     }
+    if (e_ret >= FP16_MAX_EXP){//carry of rounding overflows exponent
+        e_ret = FP16_MAX_EXP - 1;
+        m_ret = FP16_MAX_MAN;
+    }
     
     val = FP16_CONSTRUCTOR(s_ret, e_ret, m_ret);
     if (FP16_IS_INVALID(val)){
@@ -1045,7 +1067,7 @@ fp16_t& fp16_t::operator=(const float    &fVal){
     }
     return *this;
 }
-fp16_t& fp16_t::operator=(const int8_t   &iVal){
+FP16_INLINE fp16_t& fp16_t::operator=(const int8_t   &iVal){
     uint16_t s_ret, e_ret, m_ret;
 
     s_ret = (uint16_t)((iVal & 0x80) >> 7);
@@ -1070,7 +1092,7 @@ fp16_t& fp16_t::operator=(const int8_t   &iVal){
     val = FP16_CONSTRUCTOR(s_ret, e_ret, m_ret);
     return *this;
 }
-fp16_t& fp16_t::operator=(const uint8_t  &uiVal){
+FP16_INLINE fp16_t& fp16_t::operator=(const uint8_t  &uiVal){
     uint16_t s_ret, e_ret, m_ret;
     s_ret = 0;
     e_ret = 0;
@@ -1087,7 +1109,7 @@ fp16_t& fp16_t::operator=(const uint8_t  &uiVal){
     val = FP16_CONSTRUCTOR(s_ret, e_ret, m_ret);
     return *this;
 }
-fp16_t& fp16_t::operator=(const int16_t  &iVal){
+FP16_INLINE fp16_t& fp16_t::operator=(const int16_t  &iVal){
     if (iVal == 0){
         val = 0;
     }
@@ -1150,7 +1172,7 @@ fp16_t& fp16_t::operator=(const int16_t  &iVal){
     }
     return *this;
 }
-fp16_t& fp16_t::operator=(const uint16_t &uiVal){
+FP16_INLINE fp16_t& fp16_t::operator=(const uint16_t &uiVal){
     if (uiVal == 0){
         val = 0;
     }
@@ -1200,7 +1222,7 @@ fp16_t& fp16_t::operator=(const uint16_t &uiVal){
     }
     return *this;
 }
-fp16_t& fp16_t::operator=(const int32_t  &iVal){
+FP16_INLINE fp16_t& fp16_t::operator=(const int32_t  &iVal){
     if (iVal == 0){
         val = 0;
     }
@@ -1258,7 +1280,7 @@ fp16_t& fp16_t::operator=(const int32_t  &iVal){
     }
     return *this;
 }
-fp16_t& fp16_t::operator=(const uint32_t &uiVal){
+FP16_INLINE fp16_t& fp16_t::operator=(const uint32_t &uiVal){
     if (uiVal == 0){
         val = 0;
     }
@@ -1310,10 +1332,11 @@ fp16_t& fp16_t::operator=(const uint32_t &uiVal){
     }
     return *this;
 }
-fp16_t& fp16_t::operator=(const double   &dVal){
+FP16_INLINE fp16_t& fp16_t::operator=(const double   &dVal){
     uint16_t s_ret, e_ret, m_ret;
     uint64_t e_d, m_d;
-    uint64_t ui64_v = *((uint64_t *)&dVal);//1:11:52bit sign:exp:man
+    uint64_t ui64_v;//1:11:52bit sign:exp:man
+    memcpy(&ui64_v, &dVal, sizeof(ui64_v));
     uint32_t m_len_delta;
 
     s_ret = (uint16_t)((ui64_v & FP64_SIGN_MASK) >> FP64_SIGN_INDEX);//4Byte
@@ -1346,8 +1369,11 @@ fp16_t& fp16_t::operator=(const double   &dVal){
             if (needRound){
                 m_ret++;
             }
+            if (m_ret & FP16_MAN_HIDE_BIT){//rounded up to the minimum normal value
+                e_ret = 1;
+            }
         }
-        else if (e_d == 0x3E6u && m_d > 0){
+        else if (e_d == 0x3E6u && m_d > 0 && ROUND_TO_NEAREST == g_RoundMode){//above half of the minimum denormal
             m_ret = 1;
         }
         else{
@@ -1391,39 +1417,41 @@ fp16_t& fp16_t::operator=(const double   &dVal){
         //
     }
 
-    val = FP16_CONSTRUCTOR(s_ret, e_ret, m_ret);
-    if (FP16_IS_INVALID(val)){
+    if (e_ret >= FP16_MAX_EXP){//exponent 31 and a carry out of it both saturate
         val = (s_ret << FP16_SIGN_INDEX) | FP16_MAX;
     }
+    else{
+        val = FP16_CONSTRUCTOR(s_ret, e_ret, m_ret);
+    }
     return *this;
 }
 
 //convert
-fp16_t::operator float() const{
+FP16_INLINE fp16_t::operator float() const{
     return fp16ToFloat(val);
 }
-fp16_t::operator double() const{
+FP16_INLINE fp16_t::operator double() const{
     return fp16ToDouble(val);
 }
-fp16_t::operator int8_t() const{
+FP16_INLINE fp16_t::operator int8_t() const{
     return fp16ToInt8(val);
 }
-fp16_t::operator uint8_t() const{
+FP16_INLINE fp16_t::operator uint8_t() const{
     return fp16ToUInt8(val);
 }
-fp16_t::operator int16_t() const{
+FP16_INLINE fp16_t::operator int16_t() const{
     return fp16ToInt16(val);
 }
-fp16_t::operator uint16_t() const{
+FP16_INLINE fp16_t::operator uint16_t() const{
     return fp16ToUInt16(val);
 }
-fp16_t::operator int32_t() const{
+FP16_INLINE fp16_t::operator int32_t() const{
     return fp16ToInt32(val);
 }
-fp16_t::operator uint32_t() const{
+FP16_INLINE fp16_t::operator uint32_t() const{
     return fp16ToUInt32(val);
 }
-int fp16_t::IsInf(){
+FP16_INLINE int fp16_t::IsInf(){
     if ((val & FP16_ABS_MAX) == FP16_EXP_MASK){
         if (val & FP16_SIGN_MASK){
             return -1;
@@ -1435,33 +1463,35 @@ int fp16_t::IsInf(){
     else return 0;
 }
 
-float    fp16_t::toFloat(){
+FP16_INLINE float    fp16_t::toFloat(){
     return fp16ToFloat(val);
 }
-double   fp16_t::toDouble(){
+FP16_INLINE double   fp16_t::toDouble(){
     return fp16ToDouble(val);
 }
-int8_t   fp16_t::toInt8(){
+FP16_INLINE int8_t   fp16_t::toInt8(){
     return fp16ToInt8(val);
 }
-uint8_t  fp16_t::toUInt8(){
+FP16_INLINE uint8_t  fp16_t::toUInt8(){
     return fp16ToUInt8(val);
 }
-int16_t  fp16_t::toInt16(){
+FP16_INLINE int16_t  fp16_t::toInt16(){
     return fp16ToInt16(val);
 }
-uint16_t fp16_t::toUInt16(){
+FP16_INLINE uint16_t fp16_t::toUInt16(){
     return fp16ToUInt16(val);
 }
-int32_t  fp16_t::toInt32(){
+FP16_INLINE int32_t  fp16_t::toInt32(){
     return fp16ToInt32(val);
 }
-int32_t  fp16_t::toInt32C(){
+FP16_INLINE int32_t  fp16_t::toInt32C(){
     return fp16ToInt32(val,ROUND_TO_CEILING);
 }
-int32_t  fp16_t::toInt32F(){
+FP16_INLINE int32_t  fp16_t::toInt32F(){
     return fp16ToInt32(val,ROUND_TO_FLOOR);
 }
-uint32_t fp16_t::toUInt32(){
+FP16_INLINE uint32_t fp16_t::toUInt32(){
     return fp16ToUInt32(val);
 }
+
+#endif /*_FP16_T_CC_*/
@@ -332,6 +332,31 @@
  *@brief   print an error if input fp16 is overflow
  */
 //#define PRINT_INPUT_OVERFLOW_ERROR
+/**
+ *@ingroup decode switch
+ *@brief   fp16ToFloat/fp16ToDouble read a 65536 entries table (256KB float and 512KB
+ *         double) which is filled by the arithmetic conversion on first use
+ */
+//#define FP16_DECODE_TABLE
+/**
+ *@ingroup build switch
+ *@brief   fp16_t.cc and fp16div.cc are included by this header and their methods are
+ *         inline, so fp16_t operators and conversions in user loops can be inlined and
+ *         vectorized. It needs C++17 for the inline g_RoundMode, FP16_DECODE_TABLE
+ *         still needs fp16_table.cc to be linked
+ */
+//#define FP16_HEADER_ONLY
+
+#ifdef FP16_HEADER_ONLY
+#if __cplusplus < 201703L
+#error "FP16_HEADER_ONLY needs C++17"
+#endif
+#define FP16_INLINE                    inline
+#define FP16_STATIC                    inline
+#else
+#define FP16_INLINE
+#define FP16_STATIC                    static
+#endif
 
 /**
  *@ingroup fp16_t enum
@@ -346,6 +371,14 @@ typedef enum tagFp16RoundMode
     ROUND_MODE_RESERVED,
 } fp16RoundMode_t;
 
+/**
+ *@ingroup fp16_t global filed
+ *@brief   round mode of last valid digital used by fp16_t operators and conversions of
+ *         the calling thread, every thread starts with ROUND_TO_NEAREST. Only
+ *         ROUND_TO_NEAREST rounds, the other modes truncate
+ */
+extern thread_local fp16RoundMode_t g_RoundMode;
+
 /**
  *@ingroup fp16_t
  *@brief   Half precision float
@@ -362,20 +395,19 @@ public:
      *@ingroup fp16_t constructor
      *@brief   Constructor without any param(default constructor)
      */
-    tagFp16(void){
-        val = 0x0u;
+    constexpr tagFp16(void) :val(0x0u){
     }
     /**
      *@ingroup fp16_t constructor
      *@brief   Constructor with an uint16_t value
      */
-    tagFp16(const uint16_t &uiVal) :val(uiVal){
+    constexpr tagFp16(const uint16_t &uiVal) :val(uiVal){
     }
     /**
      *@ingroup fp16_t constructor
      *@brief   Constructor with a fp16_t object(copy constructor)
      */
-    tagFp16(const tagFp16 &fp) :val(fp.val){
+    constexpr tagFp16(const tagFp16 &fp) :val(fp.val){
     }
 
     /**
@@ -659,6 +691,64 @@ public:
  
  } fp16_t;
  
+ /**
+  *@ingroup     fp16_t constexpr static method
+  *@param [in] fAbs non-negative float less than 65520
+  *@param [in] fExp 0 on the first call
+  *@brief    Get fp16_t exponent of fAbs by exact scaling by 2, 2^exp <= fAbs < 2^(exp+1) for
+  *          normal results and 1-FP16_EXP_BIAS for denormal results
+  *@return    Return exponent of fAbs without bias
+  */
+ constexpr int Fp16ExpOf(float fAbs, int fExp){
+     return (fAbs >= 2.0f) ? Fp16ExpOf(fAbs * 0.5f, fExp + 1) :
+         (((fAbs < 1.0f) && (fExp > 1 - FP16_EXP_BIAS)) ? Fp16ExpOf(fAbs * 2.0f, fExp - 1) : fExp);
+ }
+ /**
+  *@ingroup     fp16_t constexpr static method
+  *@brief    Scale fAbs by 2^shift exactly
+  */
+ constexpr float Fp32Scale(float fAbs, int shift){
+     return (shift > 0) ? Fp32Scale(fAbs * 2.0f, shift - 1) : ((shift < 0) ? Fp32Scale(fAbs * 0.5f, shift + 1) : fAbs);
+ }
+ /**
+  *@ingroup     fp16_t constexpr static method
+  *@param [in] e_ret fp16_t exponent without bias, 1-FP16_EXP_BIAS for denormal
+  *@param [in] m_f   fAbs scaled to [0, 2048), the integer part is the mantissa with hidden bit
+  *@brief    Round m_f to nearest even and encode it, a carry to 2048 moves to the next exponent
+  *@return    Return uint16_t value of fp16_t without sign
+  */
+ constexpr uint16_t Fp16EncodeScaled(int e_ret, float m_f){
+     return (uint16_t)(((e_ret + FP16_EXP_BIAS - 1) << FP16_MAN_LEN) + (int)(uint32_t)m_f +
+         (((m_f - (float)(uint32_t)m_f) > 0.5f || ((m_f - (float)(uint32_t)m_f) == 0.5f && ((uint32_t)m_f & 1))) ? 1 : 0));
+ }
+ constexpr uint16_t Fp16EncodeAbs(float fAbs, int e_ret){
+     return Fp16EncodeScaled(e_ret, Fp32Scale(fAbs, FP16_MAN_LEN - e_ret));
+ }
+ /**
+  *@ingroup     fp16_t constexpr method
+  *@param [in] fVal float value
+  *@brief    Convert float to fp16_t at compile time, the result is the same as
+  *          fp16_t::operator=(const float&) under ROUND_TO_NEAREST except that -0.0f and
+  *          NaN give positive results. |fVal| >= 65520, Inf and NaN saturate to FP16_MAX
+  *@return    Return uint16_t value of fp16_t
+  */
+ constexpr uint16_t floatToFp16(float fVal){
+     return (fVal != fVal) ? (uint16_t)FP16_MAX :
+         ((fVal < 0.0f) ? (uint16_t)(FP16_SIGN_MASK | ((-fVal >= 65520.0f) ? FP16_MAX : Fp16EncodeAbs(-fVal, Fp16ExpOf(-fVal, 0)))) :
+         ((fVal >= 65520.0f) ? (uint16_t)FP16_MAX : Fp16EncodeAbs(fVal, Fp16ExpOf(fVal, 0))));
+ }
+ /**
+  *@ingroup     fp16_t constexpr method
+  *@brief    fp16_t literal as if the literal is assigned to a float first, e.g. 1.5_h, 2_h
+  *@return    Return fp16_t of the literal
+  */
+ constexpr fp16_t operator"" _h(long double fVal){
+     return fp16_t(floatToFp16((float)fVal));
+ }
+ constexpr fp16_t operator"" _h(unsigned long long iVal){
+     return fp16_t(floatToFp16((float)iVal));
+ }
+
  /**
   *@ingroup     fp16_t math conversion static method
   *@param [in] fpVal uint16_t value of fp16_t object
@@ -724,6 +814,32 @@ public:
   *@return    Return fp16_t value
   */
  fp16_t deq(const uint32_t &fixVal, fp16_t fpScale);
+ /**
+  *@ingroup     fp16_t math operator divided
+  *@param [in]     a     uint16_t value of fp16_t dividend
+  *@param [in]     b     uint16_t value of fp16_t divisor
+  *@param [in]     mode  round mode(fp16RoundMode_t) in bits 1..0, FP_FZ16 flushes denormals
+  *@param [in|out] flags FP_IDC/FP_DZC/FP_OFC/FP_UFC/FP_IXC of fpe.h are or-ed in
+  *@brief    Divide fp16_t by integer arithmetic and round once. Like the other fp16_t
+  *          operators, exponent 31 is finite, overflow and division by zero saturate
+  *          to FP16_MAX and zero dividend gives +0
+  *@return    Return uint16_t value of the fp16_t quotient
+  */
+ uint16_t fp16_div(uint16_t a, uint16_t b, int mode, int *flags);
+/**
+ *@ingroup     fp16_t math operator
+ *@param [in]     v1    uint16_t value of left fp16_t
+ *@param [in]     v2    uint16_t value of right fp16_t
+ *@brief    fp16_t addition, subtraction, multiplication and division rounded by roundMode
+ *          instead of g_RoundMode. ROUND_TO_CEILING and ROUND_TO_FLOOR are directed
+ *          roundings here, fp16_t operators use ROUND_TO_NEAREST or ROUND_BY_TRUNCATED.
+ *          They are instantiated for every fp16RoundMode_t but ROUND_MODE_RESERVED
+ *@return    Return uint16_t value of the fp16_t result
+ */
+template <fp16RoundMode_t roundMode> uint16_t fp16Add(uint16_t v1, uint16_t v2);
+template <fp16RoundMode_t roundMode> uint16_t fp16Sub(uint16_t v1, uint16_t v2);
+template <fp16RoundMode_t roundMode> uint16_t fp16Mul(uint16_t v1, uint16_t v2);
+template <fp16RoundMode_t roundMode> uint16_t fp16Div(uint16_t v1, uint16_t v2);
  /**
   *@ingroup fp16_t public method
   *@param [in]     val signature is negative
@@ -733,6 +849,15 @@ public:
   *@brief   Extract the sign, exponent and mantissa of a fp16_t object
   */
  void ExtractFP16(const uint16_t &val, uint16_t *s, int16_t *e, uint16_t *m);
+ /**
+  *@ingroup fp16_t public method
+  *@param [in] man       truncated mantissa
+  *@param [in] trunc_len truncated bit length
+  *@brief   judge whether to add one to the mantissa kept after truncating trunc_len bits,
+  *         by g_RoundMode as the fp16_t operators do
+  *@return  Return true if add one, otherwise false
+  */
+ bool IsRoundOne(uint64_t man, uint16_t trunc_len);
  /**
   *@ingroup fp16_t public method
   *@param [in]     negative sign is negative
@@ -831,5 +956,10 @@ public:
      return len;
  }
  
+ #ifdef FP16_HEADER_ONLY
+ #include "fp16_t.cc"
+ #include "fp16div.cc"
+ #endif
+
  #endif /*_FP16_T_H_*/
  
\ No newline at end of file
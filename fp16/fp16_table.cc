@@ -0,0 +1,202 @@
+/**
+ * @file fp16_table.cc
+ *
+ * Copyright(C), 2017 - 2018, Lxzh Tech. Co., Ltd. ALL RIGHTS RESERVED.
+ *
+ * @brief on-disk cache of generated Half precision float tables
+ *
+ * @version 1.0
+ *
+ */
+#include "fp16_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FP16_TABLE_MMAP
+#endif
+
+/**
+ *@ingroup fp16_table basic parameter
+ *@brief   table file format version, change it when fp16TableHeader_t changes
+ */
+#define FP16_TABLE_VERSION             (2u)
+/**
+ *@ingroup fp16_table basic parameter
+ *@brief   every FP16_TABLE_PROBE_STEP-th entry is calculated for the table hash
+ */
+#define FP16_TABLE_PROBE_STEP          (61u)
+/**
+ *@ingroup fp16_table basic parameter
+ *@brief   max length of a table file path
+ */
+#define FP16_TABLE_PATH_LEN            (1024)
+
+static const char g_TableMagic[8] = {'F', 'P', '1', '6', 'T', 'B', 'L', '\0'};
+
+/**
+ *@ingroup fp16_table
+ *@brief   header at the beginning of a table file, entries follow at dataOffset
+ */
+typedef struct tagFp16TableHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t elemSize;
+    uint64_t hash;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+    uint64_t checksum;                          /**< HashBytes of the dataSize entry bytes */
+    char     name[24];
+} fp16TableHeader_t;
+
+/**
+ *@ingroup fp16_table static method
+ *@brief   FNV-1a hash of size bytes
+ *@return  Return hash updated by data
+ */
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size){
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++){
+        hash ^= p[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+/**
+ *@ingroup fp16_table static method
+ *@brief   Checksum of the entries of a table
+ */
+static uint64_t TableChecksum(const uint8_t *data, uint64_t size){
+    return HashBytes(0xCBF29CE484222325ull, data, (size_t)size);
+}
+
+static uint64_t TableHash(const char *name, uint32_t elemSize, fp16TableCalc_t calc){
+    uint64_t hash = 0xCBF29CE484222325ull;
+    uint32_t version = FP16_TABLE_VERSION;
+    uint32_t semantics = FP16_TABLE_SEMANTICS;
+    hash = HashBytes(hash, &version, sizeof(version));
+    hash = HashBytes(hash, &semantics, sizeof(semantics));
+    hash = HashBytes(hash, &elemSize, sizeof(elemSize));
+    hash = HashBytes(hash, name, strlen(name) + 1);
+    uint8_t entry[sizeof(double) * 4];
+    uint32_t size = (elemSize < sizeof(entry)) ? elemSize : (uint32_t)sizeof(entry);
+    for (uint32_t i = 0; i < FP16_TABLE_ENTRIES; i += FP16_TABLE_PROBE_STEP){
+        memset(entry, 0, sizeof(entry));
+        calc(i, entry);
+        hash = HashBytes(hash, entry, size);
+    }
+    return hash;
+}
+
+static void FillTable(uint8_t *data, uint32_t elemSize, fp16TableCalc_t calc){
+    for (uint32_t i = 0; i < FP16_TABLE_ENTRIES; i++){
+        calc(i, data + (size_t)i * elemSize);
+    }
+}
+
+#ifdef FP16_TABLE_MMAP
+/**
+ *@ingroup fp16_table static method
+ *@brief   Map a table file read-only, the header must match the expected table and the
+ *         entries must match the checksum in the header
+ *@return  Return entries of the table, NULL if the file does not exist or is not valid
+ */
+static const void *MapTable(const char *path, const fp16TableHeader_t *expect){
+    int fd = open(path, O_RDONLY);
+    if (fd < 0){
+        return NULL;
+    }
+    struct stat st;
+    size_t fileSize = (size_t)(expect->dataOffset + expect->dataSize);
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != fileSize){
+        close(fd);
+        return NULL;
+    }
+    void *base = mmap(NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED){
+        return NULL;
+    }
+    fp16TableHeader_t header;
+    memcpy(&header, base, sizeof(header));
+    const uint8_t *data = (const uint8_t *)base + expect->dataOffset;
+    //the checksum is the only field not known before the entries are generated
+    uint64_t checksum = header.checksum;
+    header.checksum = expect->checksum;
+    if (memcmp(&header, expect, sizeof(header)) != 0 || checksum != TableChecksum(data, expect->dataSize)){
+        munmap(base, fileSize);
+        return NULL;
+    }
+    return data;
+}
+
+/**
+ *@ingroup fp16_table static method
+ *@brief   Write a table file through a temporary file, synced to disk before the rename,
+ *         so other processes never map a partly written table. The rename replaces a
+ *         stale file of the same name, mappings of it stay valid
+ */
+static void WriteTable(const char *path, const fp16TableHeader_t *header, const uint8_t *data){
+    char tmpPath[FP16_TABLE_PATH_LEN];
+    int len = snprintf(tmpPath, sizeof(tmpPath), "%s.%ld.tmp", path, (long)getpid());
+    if (len < 0 || len >= (int)sizeof(tmpPath)){
+        return;
+    }
+    FILE *fp = fopen(tmpPath, "wb");
+    if (fp == NULL){
+        return;
+    }
+    bool ok = (fwrite(header, sizeof(fp16TableHeader_t), 1, fp) == 1);
+    ok = ok && (fwrite(data, (size_t)header->dataSize, 1, fp) == 1);
+    ok = ok && (fflush(fp) == 0) && (fsync(fileno(fp)) == 0);
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(tmpPath, path) != 0){
+        remove(tmpPath);
+    }
+}
+#endif
+
+const void *GetFp16Table(const char *name, uint32_t elemSize, fp16TableCalc_t calc){
+#ifdef FP16_TABLE_MMAP
+    const char *dir = getenv(FP16_TABLE_CACHE_ENV);
+    if (dir != NULL && dir[0] != '\0' && strlen(name) < sizeof(((fp16TableHeader_t *)0)->name)){
+        fp16TableHeader_t header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, g_TableMagic, sizeof(header.magic));
+        header.version = FP16_TABLE_VERSION;
+        header.elemSize = elemSize;
+        header.hash = TableHash(name, elemSize, calc);
+        header.dataOffset = sizeof(fp16TableHeader_t);
+        header.dataSize = (uint64_t)FP16_TABLE_ENTRIES * elemSize;
+        strcpy(header.name, name);
+
+        char path[FP16_TABLE_PATH_LEN];
+        int len = snprintf(path, sizeof(path), "%s/%s.tbl", dir, name);
+        if (len > 0 && len < (int)sizeof(path)){
+            const void *table = MapTable(path, &header);
+            if (table == NULL){//missing, stale, truncated or corrupted
+                uint8_t *data = new uint8_t[(size_t)header.dataSize];
+                FillTable(data, elemSize, calc);
+                header.checksum = TableChecksum(data, header.dataSize);
+                WriteTable(path, &header, data);
+                table = MapTable(path, &header);
+                if (table == NULL){//directory is not writable, keep the generated one
+                    return data;
+                }
+                delete[] data;
+            }
+            return table;
+        }
+    }
+#endif
+    uint8_t *data = new uint8_t[(size_t)FP16_TABLE_ENTRIES * elemSize];
+    FillTable(data, elemSize, calc);
+    return data;
+}
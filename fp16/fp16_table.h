@@ -0,0 +1,61 @@
+/**
+ * @file fp16_table.h
+ *
+ * Copyright(C), 2017 - 2018, Lxzh Tech. Co., Ltd. ALL RIGHTS RESERVED.
+ *
+ * @brief on-disk cache of generated Half precision float tables
+ *
+ * @version 1.0
+ *
+ */
+#ifndef _FP16_TABLE_H_
+#define _FP16_TABLE_H_
+
+#include <stdint.h>
+
+/**
+ *@ingroup fp16_table basic parameter
+ *@brief   environment variable naming the directory of cached tables, tables are
+ *         generated in memory by every process when it is not set
+ */
+#define FP16_TABLE_CACHE_ENV           "FP16_TABLE_CACHE"
+/**
+ *@ingroup fp16_table basic parameter
+ *@brief   entry count of a table, one entry per fp16_t value
+ */
+#define FP16_TABLE_ENTRIES             (0x10000u)
+/**
+ *@ingroup fp16_table basic parameter
+ *@brief   version of the conversion and rounding semantics of fp16_t.cc and fp16_math.cc,
+ *         part of the table hash. Increase it with every change that gives another
+ *         result for some fp16_t input, the probe entries of the hash may miss it
+ */
+#define FP16_TABLE_SEMANTICS           (3u)
+
+/**
+ *@ingroup fp16_table
+ *@param [in]  index fp16_t value, 0 ~ FP16_TABLE_ENTRIES-1
+ *@param [out] out   table entry of index
+ *@brief   Calculate one table entry
+ */
+typedef void (*fp16TableCalc_t)(uint32_t index, void *out);
+
+/**
+ *@ingroup fp16_table method
+ *@param [in] name     table name, part of the file name, [0-9a-zA-Z_] at most 23 chars
+ *@param [in] elemSize byte size of one entry
+ *@param [in] calc     method calculating one entry
+ *@brief   Get a generated table. The table hash covers the format version, name,
+ *         element size, FP16_TABLE_SEMANTICS and calc results of probe entries, so a
+ *         table is regenerated when the code calculating it changes. With
+ *         FP16_TABLE_CACHE set, the table is mapped read-only from "<dir>/<name>.tbl"
+ *         and shared by all processes. The file is written first if it does not exist,
+ *         its header or hash does not match or its entries do not match the checksum in
+ *         it: the table goes to a temporary file that is synced and then renamed over the
+ *         old one, so readers map either the old or the new complete file; processes
+ *         mapping the old file keep it until they exit.
+ *@return  Return FP16_TABLE_ENTRIES entries which live until the process exits
+ */
+const void *GetFp16Table(const char *name, uint32_t elemSize, fp16TableCalc_t calc);
+
+#endif /*_FP16_TABLE_H_*/
@@ -10,29 +10,16 @@
  */
 
 #include "fp16_unit.h"
-
-/**
- *@ingroup fp16_t global filed
- *@brief   round mode of last valid digital
- */
-extern fp16RoundMode_t g_RoundMode;
-
-/**
- *@ingroup fp16_math inner method
- *@param [in]     ea exponent of one fp16_t/float number
- *@param [in|out] ma mantissa of one fp16_t/float number
- *@param [in]     eb exponent of another fp16_t/float number
- *@param [in|out] mb mantissa of another fp16_t/float number
- *@brief   Align exponent by shift right mantissa whoes exponent is less than another one
- */
-static void AlignManByExp(const int16_t &ea, uint64_t *ma, const int16_t &eb, uint64_t *mb){
-    if (ea != eb){
-        uint64_t* m_tmp;
-        uint16_t e_tmp = std::abs(ea - eb);
-        m_tmp = MinMan(ea, ma, eb, mb);
-        *m_tmp = RightShift(*m_tmp, e_tmp);
-    }
-}
+#include "fp16_array.h"
+#include "fp16_math.h"
+#include "fp16_simd.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string.h>
 
 fp16_t hf_relu(fp16_t fp){
     fp16_t ret;
@@ -348,358 +335,97 @@ float hf_fadd(fp16_t fp1, fp16_t fp2){
     //}
     return ret;
 }
-/********************************************************************************************/
-/*    fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+      */
-/*    fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16  */
-/********************************************************************************************/
-fp16_t hf_mma(fp16_t fpas[], fp16_t fpbs[], fp16_t c, int len){
-    fp16_t ret;
-
-    uint16_t s_ret = 0, s_c, m_pc;
-    int16_t e_ret;
-    int16_t e_c;
-    uint64_t m_ret_l;
-
-    uint16_t s_pa[MATRIX_LENGTH];
-    int16_t e_pa[MATRIX_LENGTH];
-    uint16_t m_pa[MATRIX_LENGTH];
-    uint16_t s_pb[MATRIX_LENGTH];
-    int16_t e_pb[MATRIX_LENGTH];
-    uint16_t m_pb[MATRIX_LENGTH];
-
-    uint16_t s_mul[MATRIX_LENGTH];
-    int16_t  e_mul[MATRIX_LENGTH];
-    uint64_t m_mul[MATRIX_LENGTH];
-
-    //1.Extract
-    for (int i = 0; i < MATRIX_LENGTH; i++){
-        uint16_t va = fpas[i].val;
-        uint16_t vb = fpbs[i].val;
-
-        ExtractFP16(va, s_pa + i, e_pa + i, m_pa + i);
-        ExtractFP16(vb, s_pb + i, e_pb + i, m_pb + i);
-    }
-    ExtractFP16(c.val, &s_c, &e_c, &m_pc);
-    uint64_t m_c = m_pc;
-
-    ReverseMan(s_c > 0, &m_c);
-
-    //2.Mult
-    int16_t shift_out1 = 20;
-    for (int i = 0; i < MATRIX_LENGTH; i++){
-        s_mul[i] = s_pa[i] ^ s_pb[i];
-        e_mul[i] = e_pa[i] + e_pb[i] - FP16_EXP_BIAS;
-        m_mul[i] = (uint64_t)m_pa[i] * m_pb[i];//2.20
-
-        ReverseMan(s_mul[i]>0, m_mul + i);
-        m_mul[i] = m_mul[i] << shift_out1;//2.35
-    }
-
-    //3.Align exponent and add mantissa
-    uint32_t s_add;
-    uint64_t m_add = m_mul[0];
-    int16_t e_add = e_mul[0];
-    for (int i = 1; i < MATRIX_LENGTH; i++){
-        AlignManByExp(e_add, &m_add, e_mul[i], m_mul + i);
-        e_add = std::max(e_add, e_mul[i]);
-        m_add = m_add + m_mul[i];
-    }
-    s_add = (m_add&FP64_SIGN_MASK) >> FP64_SIGN_INDEX;
-
-    //4.Align exponent to float
-    e_add = e_add - shift_out1 - FP16_MAN_LEN;
-    if (!m_add){
-        return c;
-    }
-
-    s_ret = s_add;
-    if (s_add != s_c){
-        uint64_t sum = GetManSum(e_add, m_add, e_c, m_c);
-        s_ret = (sum&FP64_SIGN_MASK) >> FP64_SIGN_INDEX;
-        ReverseMan(s_ret > 0, &m_add);
-        ReverseMan(s_ret > 0, &m_c);
-    }
-    else{
-        ReverseMan((m_add&FP64_SIGN_MASK) > 0, &m_add);
-        ReverseMan((m_c&FP64_SIGN_MASK) > 0, &m_c);
-    }
-
-    uint64_t m_trunc_r = 0;
-    uint64_t m_trunc_l = 0;
-    uint64_t trunc_bit_r = 1;
-    uint64_t trunc_mask = 1;
-    int16_t e_tmp = 0;
-
-    e_ret = std::max(e_add, e_c);
-    e_tmp = std::abs(e_add - e_c);
-    if (e_add != e_c){
-        uint64_t* m_tmp = MinMan(e_add, &m_add, e_c, &m_c);
-        if (e_tmp <= 64){
-            trunc_bit_r = 1LLu << (e_tmp - 1);
-            trunc_mask = (trunc_bit_r << 1) - 1;
-            m_trunc_r = (*m_tmp)&trunc_mask;
-            m_trunc_l = ((*m_tmp) << (64 - e_tmp))&(FP64_SIGN_MASK | FP64_ABS_MAX);
-        }
-        else{
-            trunc_bit_r = FP64_SIGN_MASK;
-            m_trunc_r = *m_tmp;
-            trunc_mask = FP64_SIGN_MASK | FP64_ABS_MAX;
-            m_trunc_l = RightShift(*m_tmp, e_tmp - 64);
-        }
-        *m_tmp = RightShift(*m_tmp, e_tmp);
-    }
-    //calculate mantissa
-    m_ret_l = m_add + m_c;
-
-    if (m_ret_l == 0){
-        ret = 0;
-        return ret;
-    }
-    uint64_t m_min = 1LLu << FP16_MAN_LEN;
-    uint64_t m_max = m_min << 1;
-    //Denormal
-    while (m_ret_l<m_min && e_ret>0){//the value of m_ret should not be smaller than 2^10
-        m_ret_l = m_ret_l << 1;
-        m_ret_l += (uint64_t)(e_tmp > 0 && e_tmp <= 64 && (trunc_bit_r&m_trunc_r));
-        m_ret_l += (uint64_t)(e_tmp > 64 && (FP64_SIGN_MASK&m_trunc_l));
-        m_trunc_l = m_trunc_l << 1;
-        trunc_bit_r >>= 1;
-        e_ret = e_ret - 1;
-    }
-    while (m_ret_l >= m_max){//the value of m_ret should be smaller than 2^11
-        trunc_bit_r <<= 1;
-        trunc_mask = (trunc_mask << 1) + 1;
-        m_trunc_l = m_trunc_l >> 1;
-        m_trunc_r = m_trunc_r | (trunc_bit_r*(m_ret_l & 1));
-        m_trunc_l = m_trunc_l | (FP64_SIGN_MASK*(m_ret_l & 1));
-        m_ret_l = m_ret_l >> 1;
-        e_ret = e_ret + 1;
-    }
-
-    bool b_last_bit = ((m_ret_l & 1) > 0);
-    bool b_trunc_high = 0;
-    bool b_trunc_left = 0;
-    b_trunc_high = (ROUND_TO_NEAREST == g_RoundMode) && ((m_trunc_l&FP64_SIGN_MASK) > 0);
-    b_trunc_left = (ROUND_TO_NEAREST == g_RoundMode) && ((m_trunc_l&FP64_ABS_MAX) > 0);
-    b_trunc_left = (b_trunc_left || (e_tmp > 64 && (m_trunc_r&(trunc_mask^trunc_bit_r))));
 
-    m_ret_l = ManRoundToNearest(b_last_bit, b_trunc_high, b_trunc_left, m_ret_l);
-
-    while (m_ret_l >= m_max || e_ret < 0){
-        m_ret_l = m_ret_l >> 1;
-        e_ret = e_ret + 1;
+/**
+ *@ingroup fp16_t static method
+ *@param [in|out] e_ret exponent of the rounded fp16_t result
+ *@param [in|out] m_ret mantissa of the rounded fp16_t result, less than 2^11
+ *@brief   Move a denormal mantissa rounded up to the hidden bit to exponent 1, and
+ *         saturate a result overflowing fp16_t to FP16_MAX as hf_mla does
+ */
+static void Fp16Normalize(int16_t &e_ret, uint16_t &m_ret){
+    if (e_ret == 0 && m_ret >= FP16_MAN_HIDE_BIT){
+        e_ret = 1;
     }
-    uint16_t shift_out3 = (e_ret == 0 && m_ret_l < (FP16_MAN_HIDE_BIT << 1));
-    m_ret_l = m_ret_l >> shift_out3;
-
-    uint16_t m_ret = (uint16_t)m_ret_l;
     if (e_ret >= FP16_MAX_EXP){
         e_ret = FP16_MAX_EXP - 1;
         m_ret = FP16_MAX_MAN;
     }
-    ret.val = FP16_CONSTRUCTOR(s_ret, e_ret, m_ret);
-
-    return ret;
 }
-
-/********************************************************************************************/
-/*    fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+      */
-/*    fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp32  */
-/********************************************************************************************/
-float hf_mma(fp16_t fpas[], fp16_t fpbs[], float c, int len){//len=16
-    //if (len != MATRIX_LENGTH){
-    //    throw "matrix length must be 16, not support other length";
-    //}
-    float ret;
-
-    uint32_t s_ret = 0, s_c;
-    int32_t e_ret;
-    int16_t e_c;
-    uint64_t m_ret_l, m_c;
-
-    uint16_t s_pa[MATRIX_LENGTH];
-    int16_t e_pa[MATRIX_LENGTH];
-    uint16_t m_pa[MATRIX_LENGTH];
-    uint16_t s_pb[MATRIX_LENGTH];
-    int16_t e_pb[MATRIX_LENGTH];
-    uint16_t m_pb[MATRIX_LENGTH];
-
-    uint16_t s_mul[MATRIX_LENGTH];
-    int16_t  e_mul[MATRIX_LENGTH];
-    uint64_t m_mul[MATRIX_LENGTH];
-
-    //1.Extract
-    for (int i = 0; i < MATRIX_LENGTH; i++){
-        uint16_t va = fpas[i].val;
-        uint16_t vb = fpbs[i].val;
-
-        ExtractFP16(va, s_pa + i, e_pa + i, m_pa + i);
-        ExtractFP16(vb, s_pb + i, e_pb + i, m_pb + i);
+/**
+ *@ingroup fp16_t static method
+ *@param [in|out] e_ret exponent of the rounded float result
+ *@param [in|out] m_ret mantissa of the rounded float result, less than 2^24
+ *@brief   Move a denormal mantissa rounded up to the hidden bit to exponent 1, and
+ *         saturate a result overflowing float to FLT_MAX as an infinite c is taken
+ */
+static void Fp32Normalize(int16_t &e_ret, uint32_t &m_ret){
+    if (e_ret == 0 && m_ret >= FP32_MAN_HIDE_BIT){
+        e_ret = 1;
     }
-    uint32_t vc = *((uint32_t *)&c);
-    s_c = FP32_EXTRAC_SIGN(vc);//4Byte
-    e_c = FP32_EXTRAC_EXP(vc); //8bits exponent
-    m_c = (uint64_t)(FP32_EXTRAC_MAN(vc));    //23 bits mantissa  [Normal:1.m Denormal:0.m]
-
-    //Denormal
-    if (e_c == 0){
-        e_c = 1;
+    if (e_ret >= FP32_MAX_EXP){
+        e_ret = FP32_MAX_EXP - 1;
+        m_ret = FP32_MAX_MAN;
     }
-    ReverseMan(s_c > 0, &m_c);
+}
+/**
+ *@ingroup fp16_t
+ *@brief   fp16_t operands of one cube block extracted for mma_mul, infinity is taken as
+ *         the maximum value and nan as zero
+ */
+typedef struct tagMmaBlock
+{
+    uint16_t s[MATRIX_LENGTH];
+    int16_t  e[MATRIX_LENGTH];
+    uint16_t m[MATRIX_LENGTH];
+} mmaBlock_t;
 
-    //2.Mult
-    int16_t shift_out1 = 20;
+/**
+ *@ingroup fp16_t static method
+ *@param [in]  fps array of one cube block
+ *@param [in]  len element count of the block, 0 ~ MATRIX_LENGTH, missing elements are zero
+ *@param [out] blk extracted operands
+ *@brief   Extract the operands of a cube block
+ */
+static void mma_extract(const fp16_t fps[], int len, mmaBlock_t *blk){
     for (int i = 0; i < MATRIX_LENGTH; i++){
-        s_mul[i] = s_pa[i] ^ s_pb[i];
-        e_mul[i] = e_pa[i] + e_pb[i] - FP16_EXP_BIAS;
-        m_mul[i] = (uint64_t)m_pa[i] * m_pb[i];//2.20
-
-        ReverseMan(s_mul[i]>0, m_mul + i);
-        m_mul[i] = m_mul[i] << shift_out1;//2.35
-    }
-
-    //3.Align exponent and add mantissa
-    uint32_t s_add;
-    uint64_t m_add = m_mul[0];
-    int16_t e_add = e_mul[0];
-    for (int i = 1; i < MATRIX_LENGTH; i++){
-        AlignManByExp(e_add, &m_add, e_mul[i], m_mul + i);
-        e_add = std::max(e_add, e_mul[i]);
-        m_add = m_add + m_mul[i];
-    }
-    s_add = (m_add&FP64_SIGN_MASK) >> FP64_SIGN_INDEX;
-
-    //4.Align exponent to float
-    e_add = e_add - shift_out1 - FP16_MAN_LEN * 2 + FP32_MAN_LEN - FP16_EXP_BIAS + FP32_EXP_BIAS;
-    if (!m_add){
-        return c;
-    }
-
-    s_ret = s_add;
-    if (s_add != s_c){
-        uint64_t sum = GetManSum(e_add, m_add, e_c, m_c);
-        s_ret = (sum&FP64_SIGN_MASK) >> FP64_SIGN_INDEX;
-        ReverseMan(s_ret > 0, &m_add);
-        ReverseMan(s_ret > 0, &m_c);
-    }
-    else{
-        ReverseMan((m_add&FP64_SIGN_MASK) > 0, &m_add);
-        ReverseMan((m_c&FP64_SIGN_MASK) > 0, &m_c);
-    }
-
-    uint64_t m_trunc_r = 0;
-    uint64_t m_trunc_l = 0;
-    uint64_t trunc_bit_r = 1;
-    uint64_t trunc_mask = 1;
-    int16_t e_tmp = 0;
-
-    e_ret = std::max(e_add, e_c);
-    e_tmp = std::abs(e_add - e_c);
-    if (e_add != e_c){
-        uint64_t* m_tmp = MinMan(e_add, &m_add, e_c, &m_c);
-        if (e_tmp <= 64){
-            trunc_bit_r = 1LLu << (e_tmp - 1);
-            trunc_mask = (trunc_bit_r << 1) - 1;
-            m_trunc_r = (*m_tmp)&trunc_mask;
-            m_trunc_l = ((*m_tmp) << (64 - e_tmp))&(FP64_SIGN_MASK | FP64_ABS_MAX);
+        if (i >= len){//zero padding of the last block
+            blk->s[i] = 0;
+            blk->e[i] = 0;
+            blk->m[i] = 0;
+            continue;
         }
-        else{
-            trunc_bit_r = FP64_SIGN_MASK;
-            m_trunc_r = *m_tmp;
-            trunc_mask = FP64_SIGN_MASK | FP64_ABS_MAX;
-            m_trunc_l = RightShift(*m_tmp, e_tmp - 64);
+        ExtractFP16(fps[i].val, blk->s + i, blk->e + i, blk->m + i);
+        if (FP16_IS_INF(fps[i].val)){
+            blk->e[i] = FP16_MAX_VALID_EXP;
+            blk->m[i] = FP16_MAX_MAN;
+        }
+        else if (FP16_IS_NAN(fps[i].val)){
+            blk->e[i] = 0;
+            blk->m[i] = 0;
         }
-        *m_tmp = RightShift(*m_tmp, e_tmp);
-    }
-    //calculate mantissa
-    m_ret_l = m_add + m_c;
-
-    if (m_ret_l == 0){
-        ret = 0;
-        return ret;
-    }
-    uint64_t m_min = 1LLu << FP32_MAN_LEN;
-    uint64_t m_max = m_min << 1;
-    //Denormal
-    while (m_ret_l<m_min && e_ret>0){//the value of m_ret should not be smaller than 2^23
-        m_ret_l = m_ret_l << 1;
-        m_ret_l += (uint64_t)(e_tmp > 0 && e_tmp <= 64 && (trunc_bit_r&m_trunc_r));
-        m_ret_l += (uint64_t)(e_tmp > 64 && (FP64_SIGN_MASK&m_trunc_l));
-        m_trunc_l = m_trunc_l << 1;
-        trunc_bit_r >>= 1;
-        e_ret = e_ret - 1;
-    }
-    while (m_ret_l >= m_max){//the value of m_ret should be smaller than 2^24
-        trunc_bit_r <<= 1;
-        trunc_mask = (trunc_mask << 1) + 1;
-        m_trunc_l = m_trunc_l >> 1;
-        //if (m_ret_l & 1){
-        m_trunc_r = m_trunc_r | (trunc_bit_r*(m_ret_l & 1));
-        m_trunc_l = m_trunc_l | (FP64_SIGN_MASK*(m_ret_l & 1));
-        //}
-        m_ret_l = m_ret_l >> 1;
-        e_ret = e_ret + 1;
-    }
-
-    bool b_last_bit = ((m_ret_l & 1) > 0);
-    bool b_trunc_high = 0;
-    bool b_trunc_left = 0;
-    b_trunc_high = (ROUND_TO_NEAREST == g_RoundMode) && ((m_trunc_l&FP64_SIGN_MASK) > 0);
-    b_trunc_left = (ROUND_TO_NEAREST == g_RoundMode) && ((m_trunc_l&FP64_ABS_MAX) > 0);
-    b_trunc_left = (b_trunc_left || (e_tmp > 64 && (m_trunc_r&(trunc_mask^trunc_bit_r))));
-
-    m_ret_l = ManRoundToNearest(b_last_bit, b_trunc_high, b_trunc_left, m_ret_l);
-
-    while (m_ret_l >= m_max || e_ret < 0){
-        m_ret_l = m_ret_l >> 1;
-        e_ret = e_ret + 1;
     }
-    uint16_t shift_out3 = (e_ret == 0 && m_ret_l < (FP32_MAN_HIDE_BIT << 1));
-    m_ret_l = m_ret_l >> shift_out3;
-
-    uint32_t m_ret = (uint32_t)m_ret_l;
-    uint32_t ret_tmp = FP32_CONSTRUCTOR(s_ret, e_ret, m_ret);
-    ret = *((float *)&ret_tmp);
-
-    return ret;
 }
-
-
-static void mma_mul(fp16_t fpas[], fp16_t fpbs[], int16_t shift_out, int e_bias, uint16_t *s_mul, int16_t *e_mul, int64_t *m_mul){
-    uint16_t s_pa[MATRIX_LENGTH];
-    int16_t e_pa[MATRIX_LENGTH];
-    uint16_t m_pa[MATRIX_LENGTH];
-    uint16_t s_pb[MATRIX_LENGTH];
-    int16_t e_pb[MATRIX_LENGTH];
-    uint16_t m_pb[MATRIX_LENGTH];
-
+/**
+ *@ingroup fp16_t static method
+ *@param [in]  pa        operands A of one cube block
+ *@param [in]  pb        operands B of one cube block
+ *@param [in]  shift_out left shift bits of the 22 bits products
+ *@param [in]  e_bias    bias subtracted from the exponents of the products
+ *@param [out] s_mul     signs of MATRIX_LENGTH products
+ *@param [out] e_mul     exponents of MATRIX_LENGTH products
+ *@param [out] m_mul     mantissas of MATRIX_LENGTH products, normalized to bit 21 before shift_out
+ *@brief   Multiply a cube block exactly
+ */
+static void mma_mul(const mmaBlock_t *pa, const mmaBlock_t *pb, int16_t shift_out, int e_bias, uint16_t *s_mul, int16_t *e_mul, int64_t *m_mul){
 #ifdef FP16_UNIT_DEBUG
     cout<<"************mul************"<<endl;
 #endif
-    //2.Extract and Mult
+    //2.Mult
     for (int i = 0; i < MATRIX_LENGTH; i++){
-        ExtractFP16(fpas[i].val, s_pa + i, e_pa + i, m_pa + i);
-        ExtractFP16(fpbs[i].val, s_pb + i, e_pb + i, m_pb + i);
-        if (FP16_IS_INF(fpas[i].val)){
-            e_pa[i] = FP16_MAX_VALID_EXP;
-            m_pa[i] = FP16_MAX_MAN;
-        }
-        else if (FP16_IS_NAN(fpas[i].val)){
-            e_pa[i] = 0;
-            m_pa[i] = 0;
-        }
-        if (FP16_IS_INF(fpbs[i].val)){
-            e_pb[i] = FP16_MAX_VALID_EXP;
-            m_pb[i] = FP16_MAX_MAN;
-        }
-        else if (FP16_IS_NAN(fpbs[i].val)){
-            e_pb[i] = 0;
-            m_pb[i] = 0;
-        }
-
-        s_mul[i] = s_pa[i] ^ s_pb[i];
-        e_mul[i] = e_pa[i] + e_pb[i] - FP16_EXP_BIAS - e_bias;
-        m_mul[i] = (uint64_t)m_pa[i] * m_pb[i];//2.20
+        s_mul[i] = pa->s[i] ^ pb->s[i];
+        e_mul[i] = pa->e[i] + pb->e[i] - FP16_EXP_BIAS - e_bias;
+        m_mul[i] = (uint64_t)pa->m[i] * pb->m[i];//2.20
 
         if (m_mul[i] == 0){
             e_mul[i] = 0;
@@ -717,6 +443,38 @@ static void mma_mul(fp16_t fpas[], fp16_t fpbs[], int16_t shift_out, int e_bias,
     }
 }
 
+/**
+ *@ingroup fp16_t static method
+ *@param [in] e_max maximum exponent of the block
+ *@param [in] s     sign of a product or c
+ *@param [in] e     exponent of a product or c
+ *@param [in] m     mantissa of a product or c
+ *@brief   Align a term to the maximum exponent, bits shifted out are truncated and a term
+ *         52 or more bits below is dropped
+ *@return  Return signed aligned mantissa
+ */
+static inline int64_t MmaAlign(int16_t e_max, uint16_t s, int16_t e, int64_t m){
+    uint16_t e_tmp = (uint16_t)(e_max - e);
+    if (e_tmp){
+        if (e_tmp>=52){
+            m = 0;
+        }
+        else{
+            m = m >> e_tmp;
+        }
+    }
+    return s ? -m : m;
+}
+/**
+ *@ingroup fp16_t static method
+ *@param [in]  s_mul signs of MATRIX_LENGTH products and c
+ *@param [in]  e_mul exponents of MATRIX_LENGTH products and c
+ *@param [in]  m_mul mantissas of MATRIX_LENGTH products and c
+ *@param [out] s_ret sign of the sum
+ *@param [out] e_ret exponent of the sum
+ *@param [out] m_ret mantissa of the sum
+ *@brief   Add a cube block, mantissas are truncated after aligned to the maximum exponent
+ */
 static void mma_add(uint16_t *s_mul, int16_t *e_mul, int64_t *m_mul, uint16_t &s_ret, int16_t &e_ret, uint64_t &m_ret){
     int16_t e_max = -255;//less than double FP32_EXP_BIAS
     for (int32_t i = 0; i < MATRIX_LENGTH + 1; i++){
@@ -737,22 +495,10 @@ static void mma_add(uint16_t *s_mul, int16_t *e_mul, int64_t *m_mul, uint16_t &s
 #endif
     int64_t m_tmp;
     for (int i = 0; i < MATRIX_LENGTH + 1; i++){
-        uint16_t e_tmp = (uint16_t)(e_max - e_mul[i]);
-        m_tmp = m_mul[i];
-        if (e_tmp){
-            if (e_tmp>=52){
-                m_tmp = 0;
-            }
-            else{
-                m_tmp = m_tmp >> e_tmp;
-            }
-        }
-        if (s_mul[i]){
-            m_tmp = -m_tmp;
-        }
+        m_tmp = MmaAlign(e_max, s_mul[i], e_mul[i], m_mul[i]);
         m_add += m_tmp;
 #ifdef FP16_UNIT_DEBUG
-        cout << "mul[" <<setw(2)<<i<<"]="<<setw(16)<<m_mul[i]<<" e="<<setw(3)<<e_mul[i]<<" ed="<<setw(3)<<e_tmp<<" m="<<setw(17)<<m_tmp<<setw(20)<< m_add << endl;
+        cout << "mul[" <<setw(2)<<i<<"]="<<setw(16)<<m_mul[i]<<" e="<<setw(3)<<e_mul[i]<<" ed="<<setw(3)<<(uint16_t)(e_max - e_mul[i])<<" m="<<setw(17)<<m_tmp<<setw(20)<< m_add << endl;
         //std::printf("mul[%2d]=%16lld ed=%3d m=%17lld %20lld\n", i, m_mul[i], e_tmp, i, m_tmp, m_add);
 #endif
     }
@@ -761,11 +507,162 @@ static void mma_add(uint16_t *s_mul, int16_t *e_mul, int64_t *m_mul, uint16_t &s
     m_ret = (uint64_t)std::abs(m_add);
 }
 
+#ifdef FP16_SIMD_X86
+FP16_AVX512_BEGIN
+/**
+ *@ingroup fp16_t static method
+ *@brief   mma_mul and mma_add of one cube block in 16 lanes, bit-exact with them. Products
+ *         are normalized to bit 21 by the exponent of their exact float value instead of
+ *         bit-by-bit, then aligned in 64 bits lanes by variable shifts, a shift of 52 or more
+ *         bits gives zero as MmaAlign does since no term reaches 2^52. c is the scalar lane
+ *         MATRIX_LENGTH of s_mul/e_mul/m_mul
+ */
+FP16_TARGET_AVX512 static void MmaSumAVX512(const mmaBlock_t *pa, const mmaBlock_t *pb, int16_t shift_out, int e_bias,
+                                            const uint16_t *s_mul, const int16_t *e_mul, const int64_t *m_mul,
+                                            uint16_t &s_ret, int16_t &e_ret, uint64_t &m_ret){
+    //1.Mult
+    __m512i m = _mm512_mullo_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)pa->m)),
+                                   _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)pb->m)));
+    __m512i e = _mm512_add_epi32(_mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i *)pa->e)),
+                                 _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i *)pb->e)));
+    __m256i s = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)pa->s), _mm256_loadu_si256((const __m256i *)pb->s));
+    __mmask16 nonzero = _mm512_test_epi32_mask(m, m);
+    __mmask16 negative = _mm256_test_epi16_mask(s, s);
+    __m512i log2 = _mm512_srli_epi32(_mm512_castps_si512(_mm512_cvtepi32_ps(m)), FP32_MAN_LEN);
+    __m512i shift = _mm512_sub_epi32(_mm512_set1_epi32(21 + FP32_EXP_BIAS), log2);
+    m = _mm512_sllv_epi32(m, shift);//bit21, zero stays zero
+    e = _mm512_sub_epi32(e, _mm512_add_epi32(shift, _mm512_set1_epi32(FP16_EXP_BIAS + e_bias)));
+
+    //2.Align exponent and add mantissa
+    int16_t e_max = -255;//less than double FP32_EXP_BIAS
+    if (nonzero){
+        e_max = std::max(e_max, (int16_t)_mm512_mask_reduce_max_epi32(nonzero, e));
+    }
+    if (m_mul[MATRIX_LENGTH] && e_mul[MATRIX_LENGTH] > e_max){
+        e_max = e_mul[MATRIX_LENGTH];
+    }
+    __m512i delta = _mm512_sub_epi32(_mm512_set1_epi32(e_max), e);
+    __m128i count = _mm_cvtsi32_si128(shift_out);
+    __m512i lo = _mm512_sll_epi64(_mm512_cvtepu32_epi64(_mm512_castsi512_si256(m)), count);
+    __m512i hi = _mm512_sll_epi64(_mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(m, 1)), count);
+    lo = _mm512_srlv_epi64(lo, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(delta)));
+    hi = _mm512_srlv_epi64(hi, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(delta, 1)));
+    lo = _mm512_mask_sub_epi64(lo, (__mmask8)negative, _mm512_setzero_si512(), lo);
+    hi = _mm512_mask_sub_epi64(hi, (__mmask8)(negative >> 8), _mm512_setzero_si512(), hi);
+    int64_t m_add = _mm512_reduce_add_epi64(_mm512_add_epi64(lo, hi));
+    m_add += MmaAlign(e_max, s_mul[MATRIX_LENGTH], e_mul[MATRIX_LENGTH], m_mul[MATRIX_LENGTH]);
+
+    e_ret = e_max;
+    s_ret = m_add < 0 ? 1 : 0;
+    m_ret = (uint64_t)std::abs(m_add);
+}
+FP16_AVX512_END
+
+/**
+ *@ingroup fp16_t static method
+ *@brief   MmaSumAVX512 in two halves of 8 lanes
+ */
+FP16_TARGET_AVX2 static void MmaSumAVX2(const mmaBlock_t *pa, const mmaBlock_t *pb, int16_t shift_out, int e_bias,
+                                        const uint16_t *s_mul, const int16_t *e_mul, const int64_t *m_mul,
+                                        uint16_t &s_ret, int16_t &e_ret, uint64_t &m_ret){
+    //1.Mult
+    __m256i m[2], e[2], s[2];
+    __m256i e_top = _mm256_set1_epi32(-255);//less than double FP32_EXP_BIAS
+    for (int h = 0; h < 2; h++){
+        int i = h * 8;
+        m[h] = _mm256_mullo_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(pa->m + i))),
+                                  _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(pb->m + i))));
+        e[h] = _mm256_add_epi32(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(pa->e + i))),
+                                _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(pb->e + i))));
+        s[h] = _mm256_cvtepu16_epi32(_mm_xor_si128(_mm_loadu_si128((const __m128i *)(pa->s + i)),
+                                                   _mm_loadu_si128((const __m128i *)(pb->s + i))));
+        __m256i log2 = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(m[h])), FP32_MAN_LEN);
+        __m256i shift = _mm256_sub_epi32(_mm256_set1_epi32(21 + FP32_EXP_BIAS), log2);
+        __m256i zero = _mm256_cmpeq_epi32(m[h], _mm256_setzero_si256());
+        m[h] = _mm256_sllv_epi32(m[h], shift);//bit21, zero stays zero
+        e[h] = _mm256_sub_epi32(e[h], _mm256_add_epi32(shift, _mm256_set1_epi32(FP16_EXP_BIAS + e_bias)));
+        e_top = _mm256_max_epi32(e_top, _mm256_blendv_epi8(e[h], _mm256_set1_epi32(-255), zero));
+    }
+
+    //2.Align exponent and add mantissa
+    __m128i top = _mm_max_epi32(_mm256_castsi256_si128(e_top), _mm256_extracti128_si256(e_top, 1));
+    top = _mm_max_epi32(top, _mm_shuffle_epi32(top, 0x4E));
+    top = _mm_max_epi32(top, _mm_shuffle_epi32(top, 0xB1));
+    int16_t e_max = (int16_t)_mm_cvtsi128_si32(top);
+    if (m_mul[MATRIX_LENGTH] && e_mul[MATRIX_LENGTH] > e_max){
+        e_max = e_mul[MATRIX_LENGTH];
+    }
+    __m128i count = _mm_cvtsi32_si128(shift_out);
+    __m256i sum = _mm256_setzero_si256();
+    for (int h = 0; h < 2; h++){
+        __m256i delta = _mm256_sub_epi32(_mm256_set1_epi32(e_max), e[h]);
+        for (int q = 0; q < 2; q++){
+            __m128i mq = q ? _mm256_extracti128_si256(m[h], 1) : _mm256_castsi256_si128(m[h]);
+            __m128i dq = q ? _mm256_extracti128_si256(delta, 1) : _mm256_castsi256_si128(delta);
+            __m128i sq = q ? _mm256_extracti128_si256(s[h], 1) : _mm256_castsi256_si128(s[h]);
+            __m256i x = _mm256_sll_epi64(_mm256_cvtepu32_epi64(mq), count);
+            x = _mm256_srlv_epi64(x, _mm256_cvtepu32_epi64(dq));
+            __m256i neg = _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_cvtepu32_epi64(sq));
+            sum = _mm256_add_epi64(sum, _mm256_sub_epi64(_mm256_xor_si256(x, neg), neg));
+        }
+    }
+    int64_t sum2[2];
+    _mm_storeu_si128((__m128i *)sum2, _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+    int64_t m_add = sum2[0] + sum2[1];
+    m_add += MmaAlign(e_max, s_mul[MATRIX_LENGTH], e_mul[MATRIX_LENGTH], m_mul[MATRIX_LENGTH]);
+
+    e_ret = e_max;
+    s_ret = m_add < 0 ? 1 : 0;
+    m_ret = (uint64_t)std::abs(m_add);
+}
+#endif
+
+/**
+ *@ingroup fp16_t static method
+ *@param [in]     pa        operands A of one cube block
+ *@param [in]     pb        operands B of one cube block
+ *@param [in]     shift_out left shift bits of the 22 bits products
+ *@param [in]     e_bias    bias subtracted from the exponents of the products
+ *@param [in|out] s_mul     signs of products, c is at MATRIX_LENGTH
+ *@param [in|out] e_mul     exponents of products, c is at MATRIX_LENGTH
+ *@param [in|out] m_mul     mantissas of products, c is at MATRIX_LENGTH
+ *@param [out]    s_ret     sign of the sum
+ *@param [out]    e_ret     exponent of the sum
+ *@param [out]    m_ret     mantissa of the sum
+ *@brief   mma_mul and mma_add of one cube block by the instruction set of GetFp16SimdLevel(),
+ *         products are only written to s_mul/e_mul/m_mul by the scalar path
+ */
+static void MmaSum(const mmaBlock_t *pa, const mmaBlock_t *pb, int16_t shift_out, int e_bias,
+                   uint16_t *s_mul, int16_t *e_mul, int64_t *m_mul, uint16_t &s_ret, int16_t &e_ret, uint64_t &m_ret){
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        MmaSumAVX512(pa, pb, shift_out, e_bias, s_mul, e_mul, m_mul, s_ret, e_ret, m_ret);
+        return;
+    case SIMD_LEVEL_AVX2:
+        MmaSumAVX2(pa, pb, shift_out, e_bias, s_mul, e_mul, m_mul, s_ret, e_ret, m_ret);
+        return;
+#endif
+    default:
+        mma_mul(pa, pb, shift_out, e_bias, s_mul, e_mul, m_mul);
+        mma_add(s_mul, e_mul, m_mul, s_ret, e_ret, m_ret);
+        return;
+    }
+}
+
 /********************************************************************************************/
 /*    fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+      */
 /*    fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16  */
 /********************************************************************************************/
-fp16_t hf_mma(fp16_t fpas[], fp16_t fpbs[], fp16_t c, int len){
+/**
+ *@ingroup fp16_t static method
+ *@param [in] pa operands A of one cube block
+ *@param [in] pb operands B of one cube block
+ *@param [in] c  fp16_t augend
+ *@brief   Calculate one MATRIX_LENGTH cube block with fp16_t result
+ *@return  Returns fp16_t result of multiplication and addition
+ */
+static fp16_t MmaBlock(const mmaBlock_t *pa, const mmaBlock_t *pb, fp16_t c){
     fp16_t ret;
     uint16_t s_ret = 0, m_pc, m_ret;
     int16_t e_ret;
@@ -776,11 +673,10 @@ fp16_t hf_mma(fp16_t fpas[], fp16_t fpbs[], fp16_t c, int len){
      */
     int16_t shift_out = 0;
 
-    uint16_t s_mul[17];
-    int16_t  e_mul[17];
-    int64_t m_mul[17];
+    uint16_t s_mul[MATRIX_LENGTH + 1];
+    int16_t  e_mul[MATRIX_LENGTH + 1];
+    int64_t m_mul[MATRIX_LENGTH + 1];
     int16_t e_bias = shift_out + FP16_MAN_LEN;
-    mma_mul(fpas, fpbs, shift_out, e_bias, s_mul, e_mul, m_mul);
 
     int16_t man_len = FP16_MAN_LEN + 1;
     /* 1.xxx...xxx 1.10 1bit integer and 10bit decimal, total 11bit mantissia
@@ -803,7 +699,7 @@ fp16_t hf_mma(fp16_t fpas[], fp16_t fpbs[], fp16_t c, int len){
         e_mul[MATRIX_LENGTH] = e_mul[MATRIX_LENGTH] - 1;
     }
 
-    mma_add(s_mul, e_mul, m_mul, s_ret, e_ret, m_ret_l);
+    MmaSum(pa, pb, shift_out, e_bias, s_mul, e_mul, m_mul, s_ret, e_ret, m_ret_l);
 #ifdef FP16_UNIT_DEBUG
     std::printf("m_ret_l=%17lld  e_ret=%d\n", m_ret_l, e_ret);
 #endif
@@ -878,7 +774,15 @@ fp16_t hf_mma(fp16_t fpas[], fp16_t fpbs[], fp16_t c, int len){
 /*    fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+      */
 /*    fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp16*fp16+fp32  */
 /********************************************************************************************/
-float hf_mma(fp16_t fpas[], fp16_t fpbs[], float c, int len){
+/**
+ *@ingroup fp16_t static method
+ *@param [in] pa operands A of one cube block
+ *@param [in] pb operands B of one cube block
+ *@param [in] c  float augend
+ *@brief   Calculate one MATRIX_LENGTH cube block with float result
+ *@return  Returns float result of multiplication and addition
+ */
+static float MmaBlock(const mmaBlock_t *pa, const mmaBlock_t *pb, float c){
     float ret;
     uint32_t m_ret;
     int16_t e_ret;
@@ -890,13 +794,13 @@ float hf_mma(fp16_t fpas[], fp16_t fpbs[], float c, int len){
      */
     int16_t shift_out = 30;
 
-    uint16_t s_mul[17];
-    int16_t  e_mul[17];
-    int64_t m_mul[17];
+    uint16_t s_mul[MATRIX_LENGTH + 1];
+    int16_t  e_mul[MATRIX_LENGTH + 1];
+    int64_t m_mul[MATRIX_LENGTH + 1];
     int16_t e_bias = shift_out + FP16_MAN_LEN * 2 - FP32_MAN_LEN - FP32_EXP_BIAS + FP16_EXP_BIAS;
-    mma_mul(fpas, fpbs, shift_out, e_bias, s_mul, e_mul, m_mul);
 
-    uint32_t vc = *((uint32_t *)&c);
+    uint32_t vc;
+    memcpy(&vc, &c, sizeof(vc));
     s_mul[MATRIX_LENGTH] = (uint16_t)FP32_EXTRAC_SIGN(vc);//4Byte
     e_mul[MATRIX_LENGTH] = (int16_t)FP32_EXTRAC_EXP(vc); //8bits exponent
     m_mul[MATRIX_LENGTH] = (int64_t)(FP32_EXTRAC_MAN(vc));    //23 bits mantissa  [Normal:1.m Denormal:0.m]
@@ -929,7 +833,7 @@ float hf_mma(fp16_t fpas[], fp16_t fpbs[], float c, int len){
 #ifdef FP16_UNIT_DEBUG
     std::printf("mc=%17lld\n", m_mul[MATRIX_LENGTH]);
 #endif
-    mma_add(s_mul, e_mul, m_mul, s_ret, e_ret, m_ret_l);
+    MmaSum(pa, pb, shift_out, e_bias, s_mul, e_mul, m_mul, s_ret, e_ret, m_ret_l);
 #ifdef FP16_UNIT_DEBUG
     std::printf("mc=%17lld\n", m_mul[MATRIX_LENGTH]);
 #endif
@@ -984,11 +888,39 @@ float hf_mma(fp16_t fpas[], fp16_t fpbs[], float c, int len){
     //m_ret = m_ret >> shift_out3;
     Fp32Normalize(e_ret, m_ret);
     uint32_t ret_tmp = FP32_CONSTRUCTOR(s_ret, (uint32_t)e_ret, m_ret);
-    ret = *((float *)&ret_tmp);
+    memcpy(&ret, &ret_tmp, sizeof(ret));
+
+    return ret;
+}
 
+/**
+ *@ingroup fp16_t static method
+ *@param [in] fpas array A
+ *@param [in] fpbs array B
+ *@param [in] c    fp16_t or float augend
+ *@param [in] len  array length
+ *@brief   Calculate blocks of MATRIX_LENGTH in order, result of a block is c of the next one
+ *@return  Returns result of the last block, c when len is 0
+ */
+template <typename T> static T MmaChain(const fp16_t *fpas, const fp16_t *fpbs, T c, int len){
+    T ret = c;
+    mmaBlock_t pa, pb;
+    for (int k = 0; k < len; k += MATRIX_LENGTH){
+        mma_extract(fpas + k, std::min(len - k, MATRIX_LENGTH), &pa);
+        mma_extract(fpbs + k, std::min(len - k, MATRIX_LENGTH), &pb);
+        ret = MmaBlock(&pa, &pb, ret);
+    }
     return ret;
 }
 
+fp16_t hf_mma(fp16_t fpas[], fp16_t fpbs[], fp16_t c, int len){
+    return MmaChain(fpas, fpbs, c, len);
+}
+
+float hf_mma(fp16_t fpas[], fp16_t fpbs[], float c, int len){
+    return MmaChain(fpas, fpbs, c, len);
+}
+
 float d_mma(fp16_t fpas[], fp16_t fpbs[], float c, int len){
     float ret;
     double da;
@@ -1005,7 +937,412 @@ float d_mma(fp16_t fpas[], fp16_t fpbs[], float c, int len){
     return ret;
 }
 
-static const uint8_t recip_sqrt_estimate[256] = {
+/********************************************************************************************/
+/*                         C[m*n] = A[m*k] * B[k*n] + C[m*n]                               */
+/********************************************************************************************/
+/**
+ *@ingroup fp16_t unit basic parameter
+ *@brief   rows of A and columns of B in one tile of hf_gemm, a tile is the work of one thread
+ */
+#define MMA_TILE_M                     (64)
+#define MMA_TILE_N                     (64)
+/**
+ *@ingroup fp16_t unit basic parameter
+ *@brief   depth of the packed panels of one tile, multiple of MATRIX_LENGTH, two panels
+ *         of MMA_TILE_M/MMA_TILE_N x MMA_TILE_K operands are 192KB and stay in L2 cache
+ */
+#define MMA_TILE_K                     (256)
+
+/**
+ *@ingroup fp16_t unit global filed
+ *@brief   thread count set by SetFp16ThreadNum, 0 for the cpu count. It may be set while
+ *         other threads read it, no other data depends on it so relaxed order is enough
+ */
+static std::atomic<int> g_ThreadNum(0);
+
+int GetFp16ThreadNum(){
+    int num = g_ThreadNum.load(std::memory_order_relaxed);
+    if (num <= 0){
+        num = (int)std::thread::hardware_concurrency();
+    }
+    return (num > 0) ? num : 1;
+}
+
+void SetFp16ThreadNum(int num){
+    g_ThreadNum.store((num > 0) ? num : 0, std::memory_order_relaxed);
+}
+
+/**
+ *@ingroup fp16_t
+ *@brief   threads shared by all matrix methods, they are created on first use, wait for
+ *         jobs and live until the process exits
+ */
+typedef struct tagMmaPool
+{
+    std::mutex lock;
+    std::condition_variable wake;               /**< a job is published         */
+    std::condition_variable done;               /**< last worker left the job   */
+    int threadNum;                              /**< created threads            */
+    uint64_t generation;                        /**< count of published jobs    */
+    const std::function<void(size_t)> *job;
+    size_t count;
+    std::atomic<size_t> next;                   /**< next item to be taken      */
+    int seats;                                  /**< workers allowed to join    */
+    int running;                                /**< workers in the job         */
+    fp16RoundMode_t roundMode;                  /**< g_RoundMode of the caller  */
+} mmaPool_t;
+
+/**
+ *@ingroup fp16_t static method
+ *@brief   Get the thread pool, it is never destroyed so that waiting threads do not
+ *         outlive it at exit
+ */
+static mmaPool_t &GetMmaPool(){
+    static mmaPool_t *pool = new mmaPool_t();
+    return *pool;
+}
+
+/**
+ *@ingroup fp16_t static method
+ *@brief   Loop of a pool thread, take a seat of every published job while there is one
+ */
+static void MmaPoolWorker(mmaPool_t *pool){
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lk(pool->lock);
+    for (;;){
+        while (pool->generation == seen){
+            pool->wake.wait(lk);
+        }
+        seen = pool->generation;
+        if (pool->seats <= 0){
+            continue;
+        }
+        pool->seats--;
+        pool->running++;
+        const std::function<void(size_t)> *job = pool->job;
+        size_t count = pool->count;
+        g_RoundMode = pool->roundMode;
+        lk.unlock();
+        for (size_t i = pool->next++; i < count; i = pool->next++){
+            (*job)(i);
+        }
+        lk.lock();
+        if (--pool->running == 0){
+            pool->done.notify_all();
+        }
+    }
+}
+
+/**
+ *@ingroup fp16_t static method
+ *@param [in] count item count
+ *@param [in] func  method called with every item index 0 ~ count-1
+ *@brief   Run items on GetFp16ThreadNum() threads including the calling one, items are taken
+ *         in order by the first free thread, every thread uses g_RoundMode of the caller.
+ *         Other threads are from the pool, a caller finding the pool busy (another caller
+ *         or a nested call) runs the items itself
+ */
+template <typename Func> static void ParallelFor(size_t count, const Func &func){
+    static std::mutex callLock;
+    size_t num = std::min((size_t)GetFp16ThreadNum(), count);
+    std::unique_lock<std::mutex> call(callLock, std::defer_lock);
+    if (num <= 1 || !call.try_lock()){
+        for (size_t i = 0; i < count; i++){
+            func(i);
+        }
+        return;
+    }
+    mmaPool_t &pool = GetMmaPool();
+    std::function<void(size_t)> job(func);
+    {
+        std::lock_guard<std::mutex> lk(pool.lock);
+        for (; pool.threadNum < (int)num - 1; pool.threadNum++){
+            std::thread(MmaPoolWorker, &pool).detach();
+        }
+        pool.job = &job;
+        pool.count = count;
+        pool.next = 0;
+        pool.seats = (int)num - 1;
+        pool.running = 0;
+        pool.roundMode = g_RoundMode;
+        pool.generation++;
+    }
+    pool.wake.notify_all();
+    for (size_t i = pool.next++; i < count; i = pool.next++){
+        func(i);
+    }
+    std::unique_lock<std::mutex> lk(pool.lock);
+    pool.seats = 0;
+    while (pool.running > 0){
+        pool.done.wait(lk);
+    }
+}
+
+/**
+ *@ingroup fp16_t static method
+ *@param [in]  a     row-major matrix A
+ *@param [in]  lda   distance between rows of A
+ *@param [in]  rows  row count of the panel
+ *@param [in]  depth column count of the panel
+ *@param [out] panel depth/MATRIX_LENGTH blocks of every row
+ *@brief   Pack rows of A to cube blocks, the last block of a row is padded with zero
+ */
+static void PackRows(const fp16_t *a, int lda, int rows, int depth, mmaBlock_t *panel){
+    int blocks = (depth + MATRIX_LENGTH - 1) / MATRIX_LENGTH;
+    for (int i = 0; i < rows; i++){
+        for (int kb = 0; kb < blocks; kb++){
+            int k = kb * MATRIX_LENGTH;
+            mma_extract(a + (size_t)i * lda + k, std::min(depth - k, MATRIX_LENGTH), panel++);
+        }
+    }
+}
+
+/**
+ *@ingroup fp16_t static method
+ *@param [in]  b     row-major matrix B
+ *@param [in]  ldb   distance between rows of B
+ *@param [in]  cols  column count of the panel
+ *@param [in]  depth row count of the panel
+ *@param [out] panel depth/MATRIX_LENGTH blocks of every column
+ *@brief   Pack columns of B to cube blocks, the last block of a column is padded with zero
+ */
+static void PackCols(const fp16_t *b, int ldb, int cols, int depth, mmaBlock_t *panel){
+    int blocks = (depth + MATRIX_LENGTH - 1) / MATRIX_LENGTH;
+    fp16_t col[MATRIX_LENGTH];
+    for (int kb = 0; kb < blocks; kb++){
+        int k = kb * MATRIX_LENGTH;
+        int len = std::min(depth - k, MATRIX_LENGTH);
+        for (int j = 0; j < cols; j++){
+            for (int i = 0; i < len; i++){
+                col[i] = b[(size_t)(k + i) * ldb + j];
+            }
+            mma_extract(col, len, panel + (size_t)j * blocks + kb);
+        }
+    }
+}
+
+/**
+ *@ingroup fp16_t static method
+ *@param [in]     pa     packed panel of rows
+ *@param [in]     rows   row count of the panel
+ *@param [in]     pb     packed panel of columns
+ *@param [in]     cols   column count of the panel
+ *@param [in]     blocks cube block count of a row or column
+ *@param [in|out] c      float tile of rows*cols, replaced by the chained cube blocks
+ *@param [in]     ldc    distance between rows of c
+ *@brief   Calculate one tile from packed panels
+ */
+static void MmaTile(const mmaBlock_t *pa, int rows, const mmaBlock_t *pb, int cols, int blocks, float *c, size_t ldc){
+    for (int i = 0; i < rows; i++){
+        float *crow = c + (size_t)i * ldc;
+        const mmaBlock_t *ra = pa + (size_t)i * blocks;
+        for (int j = 0; j < cols; j++){
+            const mmaBlock_t *rb = pb + (size_t)j * blocks;
+            float acc = crow[j];
+            for (int kb = 0; kb < blocks; kb++){
+                acc = MmaBlock(ra + kb, rb + kb, acc);
+            }
+            crow[j] = acc;
+        }
+    }
+}
+
+void hf_gemm(int m, int n, int k, const fp16_t *a, int lda, const fp16_t *b, int ldb, float *c, int ldc){
+    if (m <= 0 || n <= 0 || k <= 0){
+        return;
+    }
+    int tilesM = (m + MMA_TILE_M - 1) / MMA_TILE_M;
+    int tilesN = (n + MMA_TILE_N - 1) / MMA_TILE_N;
+    ParallelFor((size_t)tilesM * tilesN, [&](size_t tile){
+        int i0 = (int)(tile / tilesN) * MMA_TILE_M;
+        int j0 = (int)(tile % tilesN) * MMA_TILE_N;
+        int rows = std::min(m - i0, MMA_TILE_M);
+        int cols = std::min(n - j0, MMA_TILE_N);
+        std::vector<mmaBlock_t> pa((size_t)rows * (MMA_TILE_K / MATRIX_LENGTH));
+        std::vector<mmaBlock_t> pb((size_t)cols * (MMA_TILE_K / MATRIX_LENGTH));
+        //panels follow k in order, C keeps the float result of the chained cube blocks
+        for (int k0 = 0; k0 < k; k0 += MMA_TILE_K){
+            int depth = std::min(k - k0, MMA_TILE_K);
+            int blocks = (depth + MATRIX_LENGTH - 1) / MATRIX_LENGTH;
+            PackRows(a + (size_t)i0 * lda + k0, lda, rows, depth, &pa[0]);
+            PackCols(b + (size_t)k0 * ldb + j0, ldb, cols, depth, &pb[0]);
+            MmaTile(&pa[0], rows, &pb[0], cols, blocks, c + (size_t)i0 * ldc + j0, ldc);
+        }
+    });
+}
+
+/********************************************************************************************/
+/*                     ret[i] = A[i] * B[i] + c[i], i = 0 ~ batch-1                          */
+/********************************************************************************************/
+/**
+ *@ingroup fp16_t unit basic parameter
+ *@brief   dot products taken at a time by a thread of hf_mmaBatch
+ */
+#define MMA_BATCH_CHUNK                (64)
+
+/**
+ *@ingroup fp16_t static method
+ *@brief   Calculate a batch of hf_mma by chunks of MMA_BATCH_CHUNK dot products
+ */
+template <typename T> static void MmaBatch(const fp16_t *a, int strideA, const fp16_t *b, int strideB,
+                                           const T *c, T *ret, int len, int batch){
+    if (batch <= 0){
+        return;
+    }
+    size_t chunks = ((size_t)batch + MMA_BATCH_CHUNK - 1) / MMA_BATCH_CHUNK;
+    ParallelFor(chunks, [&](size_t chunk){
+        size_t end = std::min((chunk + 1) * MMA_BATCH_CHUNK, (size_t)batch);
+        for (size_t i = chunk * MMA_BATCH_CHUNK; i < end; i++){
+            ret[i] = MmaChain(a + i * strideA, b + i * strideB, c[i], len);
+        }
+    });
+}
+
+void hf_mmaBatch(const fp16_t *a, int strideA, const fp16_t *b, int strideB, const fp16_t *c, fp16_t *ret, int len, int batch){
+    MmaBatch(a, strideA, b, strideB, c, ret, len, batch);
+}
+
+void hf_mmaBatch(const fp16_t *a, int strideA, const fp16_t *b, int strideB, const float *c, float *ret, int len, int batch){
+    MmaBatch(a, strideA, b, strideB, c, ret, len, batch);
+}
+
+/********************************************************************************************/
+/*                           y = conv2d(x, w) + bias                                        */
+/********************************************************************************************/
+/**
+ *@ingroup fp16_t
+ *@brief   position in the input image of one K index of hf_conv2d
+ */
+typedef struct tagConvTap
+{
+    size_t offset;                              /**< offset of the channel          */
+    int    dh;                                  /**< kh*dilationH - padTop          */
+    int    dw;                                  /**< kw*dilationW - padLeft         */
+} convTap_t;
+
+/**
+ *@ingroup fp16_t static method
+ *@param [in]  x         one input image
+ *@param [in]  param     shape of hf_conv2d
+ *@param [in]  pixStride distance between pixels of one channel
+ *@param [in]  taps      taps of the panel depth, a multiple of MATRIX_LENGTH except the last one
+ *@param [in]  depth     row count of the panel
+ *@param [in]  pix0      first output pixel of the panel
+ *@param [in]  ow        output width
+ *@param [in]  cols      column count of the panel
+ *@param [out] panel     depth/MATRIX_LENGTH blocks of every column
+ *@brief   Pack columns of the im2col matrix of x to cube blocks directly from the image,
+ *         pixels in the padding are zero
+ */
+static void PackConvCols(const fp16_t *x, const fp16ConvParam_t *param, int pixStride, const convTap_t *taps,
+                         int depth, int pix0, int ow, int cols, mmaBlock_t *panel){
+    int blocks = (depth + MATRIX_LENGTH - 1) / MATRIX_LENGTH;
+    fp16_t col[MATRIX_LENGTH];
+    for (int j = 0; j < cols; j++){
+        int ih0 = ((pix0 + j) / ow) * param->strideH;
+        int iw0 = ((pix0 + j) % ow) * param->strideW;
+        for (int kb = 0; kb < blocks; kb++){
+            const convTap_t *tap = taps + kb * MATRIX_LENGTH;
+            int len = std::min(depth - kb * MATRIX_LENGTH, MATRIX_LENGTH);
+            for (int i = 0; i < len; i++){
+                int ih = ih0 + tap[i].dh;
+                int iw = iw0 + tap[i].dw;
+                if ((unsigned)ih < (unsigned)param->h && (unsigned)iw < (unsigned)param->w){
+                    col[i] = x[tap[i].offset + ((size_t)ih * param->w + iw) * pixStride];
+                }
+                else{
+                    col[i].val = 0;
+                }
+            }
+            mma_extract(col, len, panel++);
+        }
+    }
+}
+
+bool hf_conv2d(const fp16ConvParam_t *param, const fp16_t *x, const fp16_t *w, const float *bias, float *y){
+    if (param == NULL || param->format < CONV_FORMAT_NCHW || param->format >= CONV_FORMAT_RESERVED ||
+        param->n <= 0 || param->c <= 0 || param->h <= 0 || param->w <= 0 ||
+        param->cout <= 0 || param->kh <= 0 || param->kw <= 0 ||
+        param->strideH <= 0 || param->strideW <= 0 || param->dilationH <= 0 || param->dilationW <= 0 ||
+        param->padTop < 0 || param->padBottom < 0 || param->padLeft < 0 || param->padRight < 0){
+        return false;
+    }
+    if (param->h + param->padTop + param->padBottom < param->dilationH * (param->kh - 1) + 1 ||
+        param->w + param->padLeft + param->padRight < param->dilationW * (param->kw - 1) + 1){
+        return false;
+    }
+    int oh = (param->h + param->padTop + param->padBottom - param->dilationH * (param->kh - 1) - 1) / param->strideH + 1;
+    int ow = (param->w + param->padLeft + param->padRight - param->dilationW * (param->kw - 1) - 1) / param->strideW + 1;
+    bool fractal = (param->format == CONV_FORMAT_NC1HWC0);
+    int c1 = (param->c + MATRIX_LENGTH - 1) / MATRIX_LENGTH;
+    int cout1 = (param->cout + MATRIX_LENGTH - 1) / MATRIX_LENGTH;
+    int window = param->kh * param->kw;
+    int k = fractal ? c1 * window * MATRIX_LENGTH : param->c * window;
+    int pixStride = fractal ? MATRIX_LENGTH : 1;
+    size_t imageSize = (size_t)param->h * param->w;
+    size_t xSize = fractal ? (size_t)c1 * imageSize * MATRIX_LENGTH : (size_t)param->c * imageSize;
+    int pixels = oh * ow;
+
+    //im2col row k of the filter order, it is the same for all pixels and images
+    std::vector<convTap_t> taps(k);
+    for (int i = 0; i < k; i++){
+        int ch = fractal ? i / (window * MATRIX_LENGTH) : i / window;
+        int pos = fractal ? (i / MATRIX_LENGTH) % window : i % window;
+        taps[i].offset = fractal ? (size_t)ch * imageSize * MATRIX_LENGTH + i % MATRIX_LENGTH : (size_t)ch * imageSize;
+        taps[i].dh = (pos / param->kw) * param->dilationH - param->padTop;
+        taps[i].dw = (pos % param->kw) * param->dilationW - param->padLeft;
+    }
+
+    int tilesM = (param->cout + MMA_TILE_M - 1) / MMA_TILE_M;
+    int tilesN = (pixels + MMA_TILE_N - 1) / MMA_TILE_N;
+    size_t tilesImage = (size_t)tilesM * tilesN;
+    ParallelFor(tilesImage * param->n, [&](size_t tile){
+        int n = (int)(tile / tilesImage);
+        int i0 = (int)(tile % tilesImage / tilesN) * MMA_TILE_M;
+        int j0 = (int)(tile % tilesN) * MMA_TILE_N;
+        int rows = std::min(param->cout - i0, MMA_TILE_M);
+        int cols = std::min(pixels - j0, MMA_TILE_N);
+        std::vector<mmaBlock_t> pa((size_t)rows * (MMA_TILE_K / MATRIX_LENGTH));
+        std::vector<mmaBlock_t> pb((size_t)cols * (MMA_TILE_K / MATRIX_LENGTH));
+        std::vector<float> acc((size_t)rows * cols);
+        for (int i = 0; i < rows; i++){
+            std::fill(acc.begin() + (size_t)i * cols, acc.begin() + (size_t)(i + 1) * cols,
+                      (bias != NULL) ? bias[i0 + i] : 0.0f);
+        }
+        //the im2col matrix is never built, panels are packed from the image as k goes on
+        for (int k0 = 0; k0 < k; k0 += MMA_TILE_K){
+            int depth = std::min(k - k0, MMA_TILE_K);
+            int blocks = (depth + MATRIX_LENGTH - 1) / MATRIX_LENGTH;
+            PackRows(w + (size_t)i0 * k + k0, k, rows, depth, &pa[0]);
+            PackConvCols(x + n * xSize, param, pixStride, &taps[k0], depth, j0, ow, cols, &pb[0]);
+            MmaTile(&pa[0], rows, &pb[0], cols, blocks, &acc[0], cols);
+        }
+        for (int i = 0; i < rows; i++){
+            int oc = i0 + i;
+            for (int j = 0; j < cols; j++){
+                size_t pix = (size_t)j0 + j;
+                if (fractal){
+                    y[(((size_t)n * cout1 + oc / MATRIX_LENGTH) * pixels + pix) * MATRIX_LENGTH + oc % MATRIX_LENGTH] = acc[(size_t)i * cols + j];
+                }
+                else{
+                    y[((size_t)n * param->cout + oc) * pixels + pix] = acc[(size_t)i * cols + j];
+                }
+            }
+        }
+        //the last tile of the channels also clears channels of the last C0 group beyond cout
+        if (fractal && i0 + rows == param->cout){
+            for (int oc = param->cout; oc < cout1 * MATRIX_LENGTH; oc++){
+                for (int j = 0; j < cols; j++){
+                    y[(((size_t)n * cout1 + oc / MATRIX_LENGTH) * pixels + j0 + j) * MATRIX_LENGTH + oc % MATRIX_LENGTH] = 0.0f;
+                }
+            }
+        }
+    });
+    return true;
+}
+
+//3 zero bytes after the 256 entries keep 32-bit gathers of the last entries inside the table
+static const uint8_t recip_sqrt_estimate[256 + 3] = {
     255, 253, 251, 249, 247, 245, 243, 242, 240, 238, 236, 234, 233, 231, 229, 228,
     226, 224, 223, 221, 219, 218, 216, 215, 213, 212, 210, 209, 207, 206, 204, 203,
     201, 200, 198, 197, 196, 194, 193, 192, 190, 189, 188, 186, 185, 184, 183, 181,
@@ -1086,11 +1423,10 @@ static inline uint16_t hf_recipEstimate(uint16_t val){
     uint16_t ret_m = 0;
     if (hf_e > 29){
         ret_e = 0;
+        //quotient of 2^(49-e) by m with remainder in [1, m], then round it to nearest even
         uint32_t m_tmp = 1 << (49 - hf_e);
-        while (m_tmp > hf_m){
-            m_tmp = m_tmp - hf_m;
-            ret_m++;
-        }
+        ret_m = (uint16_t)((m_tmp - 1) / hf_m);
+        m_tmp -= (uint32_t)ret_m * hf_m;
         if ((m_tmp << 1) > hf_m || (((m_tmp << 1) == hf_m) && (ret_m & 1))){
             ret_m++;
         }
@@ -1114,8 +1450,6 @@ static inline uint16_t hf_recipEstimate(uint16_t val){
 }
 
 static inline uint16_t hf_recipStepFuzed(uint16_t val){
-    fp16_t fpTwo(16384);
-    //fpTwo.val = 16384;
     fp16_t negfp;
     negfp.val = ((~(val))&FP16_SIGN_MASK) | (val&FP16_ABS_MAX);
     uint16_t est = hf_recipEstimate(val);
@@ -1125,15 +1459,15 @@ static inline uint16_t hf_recipStepFuzed(uint16_t val){
     float tmp = ret;
     float fx = x;
     for (int i = 0; i < 2; i++){
-        //ret = ret*(fpTwo - fp*ret);
+        //ret = ret*(2.0_h - fp*ret);
         tmp = tmp*(2.0f - fx*tmp);
     }
     ret = tmp;
 
     //Xn+1=Xnx(2.0-axXn); a is input, iteration 4 times
     //for (int i = 0; i < 4; i++){
-    //    //ret = ret*(fpTwo - fp*ret);
-    //    ret = ret*hf_mla(negfp, ret, fpTwo);
+    //    //ret = ret*(2.0_h - fp*ret);
+    //    ret = ret*hf_mla(negfp, ret, 2.0_h);
     //}
     return ret.val;
 }
@@ -1177,9 +1511,6 @@ static inline uint16_t hf_recipSqrtEstimate(uint16_t val){
 }
 
 static inline uint16_t hf_recipSqrtStepFuzed(uint16_t val){
-    fp16_t fpThree(16896);
-    //fpThreeHalf.val = 15872;//1.5f
-    //fpHalf.val = 14336;
     fp16_t x(val);
 
     uint16_t est = hf_recipSqrtEstimate(val);
@@ -1192,7 +1523,7 @@ static inline uint16_t hf_recipSqrtStepFuzed(uint16_t val){
     ret = tmp;
     //Xn+1=Xnx(3-axXnxXn)/2; a is input, iteration 4 times
     //for (int i = 0; i < 2; i++){
-    //    ret = hf_half(ret*(fpThree - x*ret*ret));
+    //    ret = hf_half(ret*(3.0_h - x*ret*ret));
     //}
     return ret.val;
 }
@@ -1220,3 +1551,409 @@ fp16_t hf_recipsqrt(fp16_t fp){
     }
     return ret;
 }
+
+/**
+ *@ingroup fp16_t static method
+ *@brief   scalar form of hf_recipN and hf_recipsqrtN
+ */
+template <fp16_t (*calc)(fp16_t)> static void RecipScalar(const fp16_t *src, fp16_t *dst, size_t n){
+    for (size_t i = 0; i < n; i++){
+        dst[i] = calc(src[i]);
+    }
+}
+
+#ifdef FP16_SIMD_X86
+/**
+ *@ingroup fp16_t static method
+ *@param [in] h fp16_t values in the low 16 bits of each lane, exponent 31 is finite
+ *@brief   Convert fp16_t to float by m*2^(e-25) with e and m of ExtractFP16
+ *@return  Return float values
+ */
+FP16_TARGET_AVX2 static inline __m256 Fp16x8ToFloatExactAVX2(__m256i h){
+    __m256i e = _mm256_and_si256(_mm256_srli_epi32(h, FP16_MAN_LEN), _mm256_set1_epi32(FP16_MAX_EXP));
+    __m256i m = _mm256_and_si256(h, _mm256_set1_epi32(FP16_MAX_MAN));
+    m = _mm256_or_si256(m, _mm256_andnot_si256(_mm256_cmpeq_epi32(e, _mm256_setzero_si256()), _mm256_set1_epi32(FP16_MAN_HIDE_BIT)));
+    e = _mm256_max_epi32(e, _mm256_set1_epi32(1));
+    __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(e, _mm256_set1_epi32(102)), 23));//2^(e-25)
+    __m256i sign = _mm256_slli_epi32(_mm256_srli_epi32(h, FP16_SIGN_INDEX), 31);
+    return _mm256_or_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(m), scale), _mm256_castsi256_ps(sign));
+}
+
+/**
+ *@ingroup fp16_t static method
+ *@param [in]  h  fp16_t values in the low 16 bits of each lane
+ *@param [out] mn mantissa of ExtractFP16 normalised to bit 15 as fp16_normalise does
+ *@brief   Calculate the exponent after fp16_normalise, log2 of m is read from float m
+ *@return  Return e + 5 - normalise shift
+ */
+FP16_TARGET_AVX2 static inline __m256i Fp16NormaliseAVX2(__m256i h, __m256i *mn){
+    __m256i e = _mm256_and_si256(_mm256_srli_epi32(h, FP16_MAN_LEN), _mm256_set1_epi32(FP16_MAX_EXP));
+    __m256i m = _mm256_and_si256(h, _mm256_set1_epi32(FP16_MAX_MAN));
+    m = _mm256_or_si256(m, _mm256_andnot_si256(_mm256_cmpeq_epi32(e, _mm256_setzero_si256()), _mm256_set1_epi32(FP16_MAN_HIDE_BIT)));
+    e = _mm256_max_epi32(e, _mm256_set1_epi32(1));
+    __m256i log2m = _mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(m)), 23), _mm256_set1_epi32(127));
+    *mn = _mm256_sllv_epi32(m, _mm256_sub_epi32(_mm256_set1_epi32(15), log2m));
+    return _mm256_sub_epi32(_mm256_add_epi32(e, log2m), _mm256_set1_epi32(10));
+}
+
+/**
+ *@ingroup fp16_t static method
+ *@brief   AVX2 lane version of hf_recip, the estimate of hf_recipEstimate uses float
+ *         division whose truncation is the integer quotient since both operands and the
+ *         quotient are small, Newton steps are the same unfused float operations
+ */
+template <int cvtRound> FP16_TARGET_AVX2 FP16_NO_CONTRACT static inline __m128i RecipX8AVX2(__m128i val){
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i h = _mm256_cvtepu16_epi32(val);
+    __m256i sign = _mm256_and_si256(h, _mm256_set1_epi32(FP16_SIGN_MASK));
+    __m256i e = _mm256_and_si256(_mm256_srli_epi32(h, FP16_MAN_LEN), _mm256_set1_epi32(FP16_MAX_EXP));
+    __m256i m = _mm256_or_si256(_mm256_and_si256(h, _mm256_set1_epi32(FP16_MAX_MAN)), _mm256_set1_epi32(FP16_MAN_HIDE_BIT));
+    __m256i mn;
+    __m256i en = Fp16NormaliseAVX2(h, &mn);
+
+    //e<=29: ret_e = 29 - e, ret_m = ((2^19 / (mn >> 6 | 1) + 1) >> 1) << 2, halved for ret_e = 0
+    __m256i d = _mm256_or_si256(_mm256_srli_epi32(mn, 6), one);
+    __m256i q = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_set1_ps((float)(1 << 19)), _mm256_cvtepi32_ps(d)));
+    __m256i retE = _mm256_sub_epi32(_mm256_set1_epi32(29), en);
+    __m256i retM = _mm256_slli_epi32(_mm256_srli_epi32(_mm256_add_epi32(q, one), 1), 2);
+    retM = _mm256_srlv_epi32(retM, _mm256_and_si256(_mm256_cmpeq_epi32(retE, zero), one));
+    __m256i est = _mm256_or_si256(_mm256_slli_epi32(retE, FP16_MAN_LEN), _mm256_and_si256(retM, _mm256_set1_epi32(FP16_MAX_MAN)));
+
+    //e>29: denormal quotient of 2^(49-e) by m with remainder in [1, m], rounded to nearest even
+    __m256i big = _mm256_sllv_epi32(one, _mm256_sub_epi32(_mm256_set1_epi32(49), e));
+    __m256 mf = _mm256_cvtepi32_ps(m);
+    __m256i qd = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(big, one)), mf));
+    __m256i rem2 = _mm256_slli_epi32(_mm256_sub_epi32(big, _mm256_mullo_epi32(qd, m)), 1);
+    __m256i up = _mm256_or_si256(_mm256_cmpgt_epi32(rem2, m),
+                                 _mm256_and_si256(_mm256_cmpeq_epi32(rem2, m), _mm256_cmpeq_epi32(_mm256_and_si256(qd, one), one)));
+    qd = _mm256_sub_epi32(qd, up);
+    est = _mm256_blendv_epi8(est, _mm256_and_si256(qd, _mm256_set1_epi32(FP16_MAX_MAN)), _mm256_cmpgt_epi32(e, _mm256_set1_epi32(29)));
+    est = _mm256_or_si256(est, sign);
+
+    //tmp = tmp*(2.0f - fx*tmp) twice
+    __m256 fx = Fp16x8ToFloatExactAVX2(h);
+    __m256 tmp = Fp16x8ToFloatExactAVX2(est);
+    for (int i = 0; i < 2; i++){
+        tmp = _mm256_mul_ps(tmp, _mm256_sub_ps(_mm256_set1_ps(2.0f), _mm256_mul_ps(fx, tmp)));
+    }
+    __m256i ret = _mm256_cvtepu16_epi32(_mm256_cvtps_ph(tmp, cvtRound));
+    //zero and denormals not above 256 saturate
+    __m256i tiny = _mm256_cmpgt_epi32(_mm256_set1_epi32(257), _mm256_and_si256(h, _mm256_set1_epi32(FP16_ABS_MAX)));
+    ret = _mm256_blendv_epi8(ret, _mm256_or_si256(sign, _mm256_set1_epi32(FP16_MAX)), tiny);
+    return _mm_packus_epi32(_mm256_castsi256_si128(ret), _mm256_extracti128_si256(ret, 1));
+}
+
+/**
+ *@ingroup fp16_t static method
+ *@brief   AVX2 lane version of hf_recipsqrt, the estimate of hf_recipSqrtEstimate is
+ *         gathered from recip_sqrt_estimate, Newton steps are the same unfused float
+ *         operations
+ */
+template <int cvtRound> FP16_TARGET_AVX2 FP16_NO_CONTRACT static inline __m128i RecipSqrtX8AVX2(__m128i val){
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i h = _mm256_cvtepu16_epi32(val);
+    __m256i mn;
+    __m256i en = Fp16NormaliseAVX2(h, &mn);
+
+    //index is (~e & 1) << 7 | (m >> 8 & 127), ret_e = (44 - e) >> 1
+    __m256i index = _mm256_or_si256(_mm256_slli_epi32(_mm256_andnot_si256(en, one), 7),
+                                    _mm256_and_si256(_mm256_srli_epi32(mn, 8), _mm256_set1_epi32(127)));
+    __m256i retM = _mm256_and_si256(_mm256_i32gather_epi32((const int *)recip_sqrt_estimate, index, 1), _mm256_set1_epi32(0xFF));
+    __m256i retE = _mm256_srai_epi32(_mm256_sub_epi32(_mm256_set1_epi32(44), en), 1);
+    __m256i est = _mm256_or_si256(_mm256_slli_epi32(retE, FP16_MAN_LEN), _mm256_slli_epi32(retM, 2));
+
+    //tmp = 0.5f*(tmp*(3.0f - fx*tmp*tmp)) twice
+    __m256 fx = Fp16x8ToFloatExactAVX2(h);
+    __m256 tmp = Fp16x8ToFloatExactAVX2(est);
+    for (int i = 0; i < 2; i++){
+        __m256 t = _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_mul_ps(fx, tmp), tmp));
+        tmp = _mm256_mul_ps(_mm256_set1_ps(0.5f), _mm256_mul_ps(tmp, t));
+    }
+    __m256i ret = _mm256_cvtepu16_epi32(_mm256_cvtps_ph(tmp, cvtRound));
+    //zero and negative values saturate, exponent 31 gives 0 and 1 gives 2^12
+    __m256i e = _mm256_and_si256(_mm256_srli_epi32(h, FP16_MAN_LEN), _mm256_set1_epi32(FP16_MAX_EXP));
+    ret = _mm256_andnot_si256(_mm256_cmpeq_epi32(e, _mm256_set1_epi32(FP16_MAX_EXP)), ret);
+    ret = _mm256_blendv_epi8(ret, _mm256_set1_epi32(27648), _mm256_cmpeq_epi32(h, one));
+    __m256i invalid = _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(FP16_ABS_MAX)), _mm256_setzero_si256()),
+                                      _mm256_cmpgt_epi32(h, _mm256_set1_epi32(FP16_ABS_MAX)));
+    ret = _mm256_blendv_epi8(ret, _mm256_set1_epi32(FP16_MAX), invalid);
+    return _mm_packus_epi32(_mm256_castsi256_si128(ret), _mm256_extracti128_si256(ret, 1));
+}
+
+template <fp16_t (*calc)(fp16_t), __m128i (*kernel)(__m128i)> FP16_TARGET_AVX2 static void RecipAVX2(const fp16_t *src, fp16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        _mm_storeu_si128((__m128i *)(dst + i), kernel(_mm_loadu_si128((const __m128i *)(src + i))));
+    }
+    RecipScalar<calc>(src + i, dst + i, n - i);
+}
+
+FP16_AVX512_BEGIN
+/**
+ *@ingroup fp16_t static method
+ *@brief   AVX512 lane versions of Fp16x8ToFloatExactAVX2 and Fp16NormaliseAVX2
+ */
+FP16_TARGET_AVX512 static inline __m512 Fp16x16ToFloatExactAVX512(__m512i h){
+    __m512i e = _mm512_and_si512(_mm512_srli_epi32(h, FP16_MAN_LEN), _mm512_set1_epi32(FP16_MAX_EXP));
+    __m512i m = _mm512_and_si512(h, _mm512_set1_epi32(FP16_MAX_MAN));
+    m = _mm512_mask_or_epi32(m, _mm512_test_epi32_mask(e, e), m, _mm512_set1_epi32(FP16_MAN_HIDE_BIT));
+    e = _mm512_max_epi32(e, _mm512_set1_epi32(1));
+    __m512 scale = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(e, _mm512_set1_epi32(102)), 23));//2^(e-25)
+    __m512i sign = _mm512_slli_epi32(_mm512_srli_epi32(h, FP16_SIGN_INDEX), 31);
+    return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(_mm512_mul_ps(_mm512_cvtepi32_ps(m), scale)), sign));
+}
+
+FP16_TARGET_AVX512 static inline __m512i Fp16NormaliseAVX512(__m512i h, __m512i *mn){
+    __m512i e = _mm512_and_si512(_mm512_srli_epi32(h, FP16_MAN_LEN), _mm512_set1_epi32(FP16_MAX_EXP));
+    __m512i m = _mm512_and_si512(h, _mm512_set1_epi32(FP16_MAX_MAN));
+    m = _mm512_mask_or_epi32(m, _mm512_test_epi32_mask(e, e), m, _mm512_set1_epi32(FP16_MAN_HIDE_BIT));
+    e = _mm512_max_epi32(e, _mm512_set1_epi32(1));
+    __m512i log2m = _mm512_sub_epi32(_mm512_srli_epi32(_mm512_castps_si512(_mm512_cvtepi32_ps(m)), 23), _mm512_set1_epi32(127));
+    *mn = _mm512_sllv_epi32(m, _mm512_sub_epi32(_mm512_set1_epi32(15), log2m));
+    return _mm512_sub_epi32(_mm512_add_epi32(e, log2m), _mm512_set1_epi32(10));
+}
+
+template <int cvtRound> FP16_TARGET_AVX512 FP16_NO_CONTRACT static inline __m256i RecipX16AVX512(__m256i val){
+    const __m512i one = _mm512_set1_epi32(1);
+    __m512i h = _mm512_cvtepu16_epi32(val);
+    __m512i sign = _mm512_and_si512(h, _mm512_set1_epi32(FP16_SIGN_MASK));
+    __m512i e = _mm512_and_si512(_mm512_srli_epi32(h, FP16_MAN_LEN), _mm512_set1_epi32(FP16_MAX_EXP));
+    __m512i m = _mm512_or_si512(_mm512_and_si512(h, _mm512_set1_epi32(FP16_MAX_MAN)), _mm512_set1_epi32(FP16_MAN_HIDE_BIT));
+    __m512i mn;
+    __m512i en = Fp16NormaliseAVX512(h, &mn);
+
+    __m512i d = _mm512_or_si512(_mm512_srli_epi32(mn, 6), one);
+    __m512i q = _mm512_cvttps_epi32(_mm512_div_ps(_mm512_set1_ps((float)(1 << 19)), _mm512_cvtepi32_ps(d)));
+    __m512i retE = _mm512_sub_epi32(_mm512_set1_epi32(29), en);
+    __m512i retM = _mm512_slli_epi32(_mm512_srli_epi32(_mm512_add_epi32(q, one), 1), 2);
+    retM = _mm512_mask_srli_epi32(retM, _mm512_testn_epi32_mask(retE, retE), retM, 1);
+    __m512i est = _mm512_or_si512(_mm512_slli_epi32(retE, FP16_MAN_LEN), _mm512_and_si512(retM, _mm512_set1_epi32(FP16_MAX_MAN)));
+
+    __m512i big = _mm512_sllv_epi32(one, _mm512_sub_epi32(_mm512_set1_epi32(49), e));
+    __m512i qd = _mm512_cvttps_epi32(_mm512_div_ps(_mm512_cvtepi32_ps(_mm512_sub_epi32(big, one)), _mm512_cvtepi32_ps(m)));
+    __m512i rem2 = _mm512_slli_epi32(_mm512_sub_epi32(big, _mm512_mullo_epi32(qd, m)), 1);
+    __mmask16 up = _mm512_cmpgt_epi32_mask(rem2, m) | (_mm512_cmpeq_epi32_mask(rem2, m) & _mm512_test_epi32_mask(qd, one));
+    qd = _mm512_mask_add_epi32(qd, up, qd, one);
+    est = _mm512_mask_and_epi32(est, _mm512_cmpgt_epi32_mask(e, _mm512_set1_epi32(29)), qd, _mm512_set1_epi32(FP16_MAX_MAN));
+    est = _mm512_or_si512(est, sign);
+
+    __m512 fx = Fp16x16ToFloatExactAVX512(h);
+    __m512 tmp = Fp16x16ToFloatExactAVX512(est);
+    for (int i = 0; i < 2; i++){
+        tmp = _mm512_mul_ps(tmp, _mm512_sub_ps(_mm512_set1_ps(2.0f), _mm512_mul_ps(fx, tmp)));
+    }
+    __m512i ret = _mm512_cvtepu16_epi32(_mm512_cvtps_ph(tmp, cvtRound));
+    __mmask16 tiny = _mm512_cmplt_epi32_mask(_mm512_and_si512(h, _mm512_set1_epi32(FP16_ABS_MAX)), _mm512_set1_epi32(257));
+    ret = _mm512_mask_or_epi32(ret, tiny, sign, _mm512_set1_epi32(FP16_MAX));
+    return _mm512_cvtepi32_epi16(ret);
+}
+
+template <int cvtRound> FP16_TARGET_AVX512 FP16_NO_CONTRACT static inline __m256i RecipSqrtX16AVX512(__m256i val){
+    const __m512i one = _mm512_set1_epi32(1);
+    __m512i h = _mm512_cvtepu16_epi32(val);
+    __m512i mn;
+    __m512i en = Fp16NormaliseAVX512(h, &mn);
+
+    __m512i index = _mm512_or_si512(_mm512_slli_epi32(_mm512_andnot_si512(en, one), 7),
+                                    _mm512_and_si512(_mm512_srli_epi32(mn, 8), _mm512_set1_epi32(127)));
+    __m512i retM = _mm512_and_si512(_mm512_i32gather_epi32(index, (const int *)recip_sqrt_estimate, 1), _mm512_set1_epi32(0xFF));
+    __m512i retE = _mm512_srai_epi32(_mm512_sub_epi32(_mm512_set1_epi32(44), en), 1);
+    __m512i est = _mm512_or_si512(_mm512_slli_epi32(retE, FP16_MAN_LEN), _mm512_slli_epi32(retM, 2));
+
+    __m512 fx = Fp16x16ToFloatExactAVX512(h);
+    __m512 tmp = Fp16x16ToFloatExactAVX512(est);
+    for (int i = 0; i < 2; i++){
+        __m512 t = _mm512_sub_ps(_mm512_set1_ps(3.0f), _mm512_mul_ps(_mm512_mul_ps(fx, tmp), tmp));
+        tmp = _mm512_mul_ps(_mm512_set1_ps(0.5f), _mm512_mul_ps(tmp, t));
+    }
+    __m512i ret = _mm512_cvtepu16_epi32(_mm512_cvtps_ph(tmp, cvtRound));
+    __m512i e = _mm512_and_si512(_mm512_srli_epi32(h, FP16_MAN_LEN), _mm512_set1_epi32(FP16_MAX_EXP));
+    ret = _mm512_maskz_mov_epi32(_mm512_cmpneq_epi32_mask(e, _mm512_set1_epi32(FP16_MAX_EXP)), ret);
+    ret = _mm512_mask_mov_epi32(ret, _mm512_cmpeq_epi32_mask(h, one), _mm512_set1_epi32(27648));
+    __mmask16 invalid = _mm512_testn_epi32_mask(h, _mm512_set1_epi32(FP16_ABS_MAX)) | _mm512_cmpgt_epi32_mask(h, _mm512_set1_epi32(FP16_ABS_MAX));
+    ret = _mm512_mask_mov_epi32(ret, invalid, _mm512_set1_epi32(FP16_MAX));
+    return _mm512_cvtepi32_epi16(ret);
+}
+
+template <__m256i (*kernel)(__m256i)> FP16_TARGET_AVX512 static void RecipAVX512(const fp16_t *src, fp16_t *dst, size_t n){
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        _mm256_storeu_si256((__m256i *)(dst + i), kernel(_mm256_loadu_si256((const __m256i *)(src + i))));
+    }
+    if (i < n){
+        __mmask16 mask = (__mmask16)((1u << (n - i)) - 1);
+        _mm256_mask_storeu_epi16(dst + i, mask, kernel(_mm256_maskz_loadu_epi16(mask, src + i)));
+    }
+}
+FP16_AVX512_END
+#endif
+
+void hf_recipN(const fp16_t *src, fp16_t *dst, size_t n){
+    bool nearest = (ROUND_TO_NEAREST == g_RoundMode);
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        if (nearest){
+            RecipAVX512<RecipX16AVX512<_MM_FROUND_TO_NEAREST_INT> >(src, dst, n);
+        }
+        else{//fp16_t::operator= truncates under the other modes
+            RecipAVX512<RecipX16AVX512<_MM_FROUND_TO_ZERO> >(src, dst, n);
+        }
+        return;
+    case SIMD_LEVEL_AVX2:
+        if (nearest){
+            RecipAVX2<hf_recip, RecipX8AVX2<_MM_FROUND_TO_NEAREST_INT> >(src, dst, n);
+        }
+        else{
+            RecipAVX2<hf_recip, RecipX8AVX2<_MM_FROUND_TO_ZERO> >(src, dst, n);
+        }
+        return;
+#endif
+    default:
+        (void)nearest;
+        RecipScalar<hf_recip>(src, dst, n);
+        return;
+    }
+}
+
+void hf_recipsqrtN(const fp16_t *src, fp16_t *dst, size_t n){
+    bool nearest = (ROUND_TO_NEAREST == g_RoundMode);
+    switch (GetFp16SimdLevel()){
+#ifdef FP16_SIMD_X86
+    case SIMD_LEVEL_AVX512:
+        if (nearest){
+            RecipAVX512<RecipSqrtX16AVX512<_MM_FROUND_TO_NEAREST_INT> >(src, dst, n);
+        }
+        else{//fp16_t::operator= truncates under the other modes
+            RecipAVX512<RecipSqrtX16AVX512<_MM_FROUND_TO_ZERO> >(src, dst, n);
+        }
+        return;
+    case SIMD_LEVEL_AVX2:
+        if (nearest){
+            RecipAVX2<hf_recipsqrt, RecipSqrtX8AVX2<_MM_FROUND_TO_NEAREST_INT> >(src, dst, n);
+        }
+        else{
+            RecipAVX2<hf_recipsqrt, RecipSqrtX8AVX2<_MM_FROUND_TO_ZERO> >(src, dst, n);
+        }
+        return;
+#endif
+    default:
+        (void)nearest;
+        RecipScalar<hf_recipsqrt>(src, dst, n);
+        return;
+    }
+}
+
+/********************************************************************************************/
+/*                        y[r][:] = softmax(x[r][:]), r = 0 ~ rows-1                          */
+/********************************************************************************************/
+/**
+ *@ingroup fp16_t unit basic parameter
+ *@brief   elements of a row handled at a time by the array kernels of hf_softmax
+ */
+#define SOFTMAX_CHUNK                  (512)
+/**
+ *@ingroup fp16_t unit basic parameter
+ *@brief   least elements taken at a time by a thread of hf_softmax, short rows are grouped
+ */
+#define SOFTMAX_ITEM_SIZE              (4096)
+
+/**
+ *@ingroup fp16_t static method
+ *@brief   Map fp16_t bits to int16_t keys of the same order, the map is its own inverse
+ */
+static inline int16_t SoftmaxKey(uint16_t val){
+    return (int16_t)(val ^ ((uint16_t)((int16_t)val >> 15) & 0x7FFF));
+}
+
+/**
+ *@ingroup fp16_t static method
+ *@brief   Maximum of a row, the sign of a zero maximum is not kept as it does not change x-max
+ */
+static fp16_t SoftmaxRowMax(const fp16_t *x, int cols){
+    int16_t key = SoftmaxKey(x[0].val);
+    for (int i = 1; i < cols; i++){
+        int16_t cur = SoftmaxKey(x[i].val);
+        key = (cur > key) ? cur : key;
+    }
+    fp16_t ret;
+    ret.val = (uint16_t)SoftmaxKey((uint16_t)key);
+    return ret;
+}
+
+/**
+ *@ingroup fp16_t static method
+ *@brief   Softmax of one row. x is read twice, by the max pass and by the fused sub, exp and
+ *         sum pass which writes exp into y; the scale pass then runs over y while it is hot
+ */
+static void SoftmaxRow(const fp16_t *x, fp16_t *y, int cols, fp16SoftmaxAcc_t acc){
+    fp16_t bcast[SOFTMAX_CHUNK];
+    float fpBuf[SOFTMAX_CHUNK];
+    fp16_t m = SoftmaxRowMax(x, cols);
+    for (int i = 0; i < SOFTMAX_CHUNK; i++){
+        bcast[i] = m;
+    }
+
+    fp16_t sum16;
+    sum16.val = 0;
+    float sum32 = 0.0f;
+    for (int i = 0; i < cols; i += SOFTMAX_CHUNK){
+        size_t len = (size_t)std::min(SOFTMAX_CHUNK, cols - i);
+        hf_subN(x + i, bcast, y + i, len);
+        hf_expN(y + i, y + i, len);
+        if (SOFTMAX_ACC_FP16 == acc){
+            //in order, every partial sum is rounded to fp16_t
+            for (size_t j = 0; j < len; j++){
+                sum16 = sum16 + y[i + j];
+            }
+        }
+        else{
+            fp16ToFloatN(&y[i].val, fpBuf, len);
+            for (size_t j = 0; j < len; j++){
+                sum32 += fpBuf[j];
+            }
+        }
+    }
+
+    if (SOFTMAX_ACC_FP16 == acc){
+        fp16_t r = hf_recip(sum16);
+        for (int i = 0; i < SOFTMAX_CHUNK; i++){
+            bcast[i] = r;
+        }
+        for (int i = 0; i < cols; i += SOFTMAX_CHUNK){
+            hf_mulN(y + i, bcast, y + i, (size_t)std::min(SOFTMAX_CHUNK, cols - i));
+        }
+        return;
+    }
+    //fp16_t::operator= rounds to nearest under ROUND_TO_NEAREST and truncates otherwise
+    fp16RoundMode_t roundMode = (ROUND_TO_NEAREST == g_RoundMode) ? ROUND_TO_NEAREST : ROUND_BY_TRUNCATED;
+    float inv = 1.0f / sum32;
+    for (int i = 0; i < cols; i += SOFTMAX_CHUNK){
+        size_t len = (size_t)std::min(SOFTMAX_CHUNK, cols - i);
+        fp16ToFloatN(&y[i].val, fpBuf, len);
+        for (size_t j = 0; j < len; j++){
+            fpBuf[j] *= inv;
+        }
+        floatToFp16N(fpBuf, &y[i].val, len, roundMode);
+    }
+}
+
+bool hf_softmax(const fp16_t *x, int ldx, fp16_t *y, int ldy, int rows, int cols, fp16SoftmaxAcc_t acc){
+    if (x == NULL || y == NULL || rows <= 0 || cols <= 0 || ldx < cols || ldy < cols ||
+        acc < SOFTMAX_ACC_FP32 || acc >= SOFTMAX_ACC_RESERVED){
+        return false;
+    }
+    if (x == y && ldx != ldy){
+        return false;
+    }
+    size_t rowsPerItem = std::max(1, SOFTMAX_ITEM_SIZE / cols);
+    size_t items = ((size_t)rows + rowsPerItem - 1) / rowsPerItem;
+    ParallelFor(items, [&](size_t item){
+        size_t end = std::min((item + 1) * rowsPerItem, (size_t)rows);
+        for (size_t r = item * rowsPerItem; r < end; r++){
+            SoftmaxRow(x + r * ldx, y + r * ldy, cols, acc);
+        }
+    });
+    return true;
+}
@@ -11,6 +11,7 @@
 #ifndef _FP16_UNIT_H_
 #define _FP16_UNIT_H_
 
+#include <stddef.h>
 #include "fp16_t.h"
 
 #define MATRIX_LENGTH                  (16)
@@ -81,11 +82,13 @@ float hf_fadd(fp16_t fp1, fp16_t fp2);
  *@ingroup fp16_t mathematics method
  *@param [in] fpas array A of type fp16_t
  *@param [in] fpbs array B of type fp16_t
- *@param [in] c float number c
- *@param [in] len array length (just support 16)
+ *@param [in] c fp16_t number c
+ *@param [in] len array length, any length is split into blocks of MATRIX_LENGTH,
+ *                the last block is padded with zero and c is returned when len is 0
  *@brief multiplication and addition
  *    fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+
  *    fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16
+ *    every block is calculated as the cube does, its fp16_t result is c of the next block
  *@return  Returns fp16_t result of multiplication and addition
  */
 fp16_t hf_mma(fp16_t fpas[], fp16_t fpbs[], fp16_t c, int len);
@@ -94,15 +97,130 @@ fp16_t hf_mma(fp16_t fpas[], fp16_t fpbs[], fp16_t c, int len);
  *@param [in] fpas array A of type fp16_t
  *@param [in] fpbs array B of type fp16_t
  *@param [in] c float number c
- *@param [in] len array length (just support 16)
+ *@param [in] len array length, any length is split into blocks of MATRIX_LENGTH,
+ *                the last block is padded with zero and c is returned when len is 0
  *@brief multiplication and addition
  *    fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+      
  *    fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp16a*fp16b+fp32  
+ *    every block is calculated as the cube does, its float result is c of the next block
  *@return  Returns float result of multiplication and addition
  */
 float hf_mma(fp16_t fpas[], fp16_t fpbs[], float c, int len);
 
 float d_mma(fp16_t fpas[], fp16_t fpbs[], float c, int len);
+/**
+ *@ingroup fp16_t unit method
+ *@brief   Get the thread count of matrix methods, the cpu count unless set by SetFp16ThreadNum
+ *@return  Return thread count
+ */
+int GetFp16ThreadNum();
+/**
+ *@ingroup fp16_t unit method
+ *@param [in] num thread count of matrix methods, 0 for the cpu count
+ *@brief   Set the thread count of matrix methods, results do not depend on it
+ */
+void SetFp16ThreadNum(int num);
+/**
+ *@ingroup fp16_t mathematics method
+ *@param [in]     m   row count of A and C
+ *@param [in]     n   column count of B and C
+ *@param [in]     k   column count of A and row count of B
+ *@param [in]     a   row-major matrix A[m*k]
+ *@param [in]     lda distance between rows of A, not less than k
+ *@param [in]     b   row-major matrix B[k*n]
+ *@param [in]     ldb distance between rows of B, not less than n
+ *@param [in|out] c   row-major float matrix C[m*n], replaced by A*B+C
+ *@param [in]     ldc distance between rows of C, not less than n
+ *@brief   Calculate C = A*B+C, every element of C is the same as
+ *         hf_mma(row of A, column of B, element of C, k) under g_RoundMode of the caller.
+ *         Tiles of C are calculated by GetFp16ThreadNum() threads from packed panels of
+ *         A and B
+ */
+void hf_gemm(int m, int n, int k, const fp16_t *a, int lda, const fp16_t *b, int ldb, float *c, int ldc);
+/**
+ *@ingroup fp16_t mathematics method
+ *@param [in]  a       batch arrays A, array i starts at a + i*strideA
+ *@param [in]  strideA distance between arrays of A, not less than len
+ *@param [in]  b       batch arrays B, array i starts at b + i*strideB
+ *@param [in]  strideB distance between arrays of B, not less than len
+ *@param [in]  c       batch fp16_t augends
+ *@param [out] ret     batch fp16_t results, can be the same as c
+ *@param [in]  len     array length
+ *@param [in]  batch   count of dot products
+ *@brief   Calculate ret[i] = hf_mma(A[i], B[i], c[i], len) for every i of the batch by
+ *         GetFp16ThreadNum() threads under g_RoundMode of the caller
+ */
+void hf_mmaBatch(const fp16_t *a, int strideA, const fp16_t *b, int strideB, const fp16_t *c, fp16_t *ret, int len, int batch);
+/**
+ *@ingroup fp16_t mathematics method
+ *@param [in]  a       batch arrays A, array i starts at a + i*strideA
+ *@param [in]  strideA distance between arrays of A, not less than len
+ *@param [in]  b       batch arrays B, array i starts at b + i*strideB
+ *@param [in]  strideB distance between arrays of B, not less than len
+ *@param [in]  c       batch float augends
+ *@param [out] ret     batch float results, can be the same as c
+ *@param [in]  len     array length
+ *@param [in]  batch   count of dot products
+ *@brief   Calculate ret[i] = hf_mma(A[i], B[i], c[i], len) for every i of the batch by
+ *         GetFp16ThreadNum() threads under g_RoundMode of the caller
+ */
+void hf_mmaBatch(const fp16_t *a, int strideA, const fp16_t *b, int strideB, const float *c, float *ret, int len, int batch);
+
+/**
+ *@ingroup fp16_t enum
+ *@brief   data layout of hf_conv2d
+ */
+typedef enum tagFp16ConvFormat
+{
+    CONV_FORMAT_NCHW = 0,    /**< x[N][C][H][W], w[Cout][C][KH][KW], y[N][Cout][OH][OW]       */
+    CONV_FORMAT_NC1HWC0,     /**< x[N][C1][H][W][C0], w[Cout][C1][KH][KW][C0],
+                                  y[N][Cout1][OH][OW][C0], C0 is MATRIX_LENGTH and channels
+                                  beyond C/Cout in the last C0 group are zero               */
+    CONV_FORMAT_RESERVED,
+} fp16ConvFormat_t;
+
+/**
+ *@ingroup fp16_t
+ *@brief   shape of hf_conv2d, output size is
+ *         OH = (h + padTop + padBottom - dilationH*(kh-1) - 1) / strideH + 1
+ *         OW = (w + padLeft + padRight - dilationW*(kw-1) - 1) / strideW + 1
+ */
+typedef struct tagFp16ConvParam
+{
+    fp16ConvFormat_t format;
+    int n;                                      /**< batch                      */
+    int c;                                      /**< input channels             */
+    int h;                                      /**< input height               */
+    int w;                                      /**< input width                */
+    int cout;                                   /**< output channels            */
+    int kh;                                     /**< kernel height              */
+    int kw;                                     /**< kernel width               */
+    int strideH;
+    int strideW;
+    int padTop;
+    int padBottom;
+    int padLeft;
+    int padRight;
+    int dilationH;
+    int dilationW;
+} fp16ConvParam_t;
+
+/**
+ *@ingroup fp16_t mathematics method
+ *@param [in]  param shape and layout
+ *@param [in]  x     input feature map
+ *@param [in]  w     filters
+ *@param [in]  bias  float bias of every output channel, NULL for zero
+ *@param [out] y     float output feature map
+ *@brief   Calculate 2D convolution as a GEMM of the filters and the im2col matrix of x.
+ *         Every output is hf_mma(filter, window of x, bias, K) in the order of w, that is
+ *         (c, kh, kw) with K = C*KH*KW for CONV_FORMAT_NCHW and (c1, kh, kw, c0) with
+ *         K = C1*KH*KW*C0 for CONV_FORMAT_NC1HWC0, where one cube block is the C0 channels
+ *         of one kernel position. im2col is streamed into the packed panels of a tile, and
+ *         tiles are calculated by GetFp16ThreadNum() threads under g_RoundMode of the caller
+ *@return  Return false if param is not valid, y is not changed then
+ */
+bool hf_conv2d(const fp16ConvParam_t *param, const fp16_t *x, const fp16_t *w, const float *bias, float *y);
 
 /**
  *@ingroup fp16_t mathematics method
@@ -115,5 +233,56 @@ fp16_t hf_half(fp16_t fp);
 fp16_t hf_recip(fp16_t fp);
 
 fp16_t hf_recipsqrt(fp16_t fp);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate reciprocal of every element, results are the same as hf_recip. The
+ *         estimate and the two Newton steps are done in AVX2/AVX512 lanes when available
+ */
+void hf_recipN(const fp16_t *src, fp16_t *dst, size_t n);
+/**
+ *@ingroup fp16_t mathematics array method
+ *@param [in]  src fp16_t objects to be calculate
+ *@param [out] dst fp16_t results, can be the same as src
+ *@param [in]  n   element count
+ *@brief   Calculate reciprocal square root of every element, results are the same as
+ *         hf_recipsqrt. The estimate is gathered from the table and the two Newton steps
+ *         are done in AVX2/AVX512 lanes when available
+ */
+void hf_recipsqrtN(const fp16_t *src, fp16_t *dst, size_t n);
+
+
+/**
+ *@ingroup fp16_t enum
+ *@brief   intermediate precision of hf_softmax
+ */
+typedef enum tagFp16SoftmaxAcc
+{
+    SOFTMAX_ACC_FP32 = 0,    /**< exp values are summed in float and scaled by float 1/sum,
+                                  y = fp16_t(float(e) * (1.0f/sum))                          */
+    SOFTMAX_ACC_FP16,        /**< exp values are summed in fp16_t in order and scaled by
+                                  fp16_t, y = e * hf_recip(sum)                               */
+    SOFTMAX_ACC_RESERVED,
+} fp16SoftmaxAcc_t;
+
+/**
+ *@ingroup fp16_t mathematics method
+ *@param [in]  x    input matrix [rows][ldx]
+ *@param [in]  ldx  leading dimension of x
+ *@param [out] y    output matrix [rows][ldy], can be the same as x with ldy equal to ldx
+ *@param [in]  ldy  leading dimension of y
+ *@param [in]  rows row count
+ *@param [in]  cols element count of a row
+ *@param [in]  acc  intermediate precision of the sum and the scale
+ *@brief   Calculate softmax of every row. With m the row maximum, e = hf_exp(x - m) is the
+ *         same as the fp16_t operators and hf_exp give, then e is summed and scaled as acc
+ *         sets. x is swept twice, one for m and one for e and the sum, and the scale pass
+ *         runs over the row of y just written. Rows are calculated by GetFp16ThreadNum()
+ *         threads under g_RoundMode of the caller
+ *@return  Return false if a parameter is not valid, y is not changed then
+ */
+bool hf_softmax(const fp16_t *x, int ldx, fp16_t *y, int ldy, int rows, int cols, fp16SoftmaxAcc_t acc = SOFTMAX_ACC_FP32);
 
 #endif /*_FP16_UNIT_H_*/
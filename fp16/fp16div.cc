@@ -1,40 +1,120 @@
-uint16_t fp16_div(uint16_t a, uint16_t b, int mode, int *flags)
+/**
+ * @file fp16div.cc
+ *
+ * Copyright(C), 2017 - 2018, Lxzh Tech. Co., Ltd. ALL RIGHTS RESERVED.
+ *
+ * @brief Integer division of Half precision float
+ *
+ * @version 1.0
+ *
+ */
+#ifndef _FP16DIV_CC_
+#define _FP16DIV_CC_
+
+#include "fp16_t.h"
+#include "fpe.h"
+
+/**
+ *@ingroup fp16_t division static method
+ *@brief   Unpack fp16_t, exponent 31 is a finite exponent as everywhere in fp16_t,
+ *         denormal exponent is 1 and denormal input is flushed under FP_FZ16
+ */
+FP16_STATIC void fp16_unpack(int *sgn, int *exp, uint16_t *mnt, uint16_t x, int mode, int *flags)
+{
+    *sgn = FP16_EXTRAC_SIGN(x);
+    *exp = FP16_EXTRAC_EXP(x);
+    *mnt = x & FP16_MAX_MAN;
+
+    if (*exp) {
+        *mnt |= FP16_MAN_HIDE_BIT;
+    } else {
+        ++*exp;
+        if ((mode & FP_FZ16) && *mnt) {
+            *flags |= FP_IDC;
+            *mnt = 0;
+        }
+    }
+}
+
+/**
+ *@ingroup fp16_t division static method
+ *@brief   Move the leading one of a non-zero mantissa to the hidden bit
+ */
+FP16_STATIC uint16_t fp16_normalise(uint16_t mnt, int *exp)
+{
+    int shift = Clz32(mnt) - (31 - FP16_MAN_LEN);
+    *exp -= shift;
+    return mnt << shift;
+}
+
+/**
+ *@ingroup fp16_t division static method
+ *@param [in] mnt leading one at bit 14, bits 3..0 are guard bits with sticky at bit 0
+ *@brief   Round to fp16_t by rtab, overflow saturates to FP16_MAX since fp16_t has no inf
+ */
+FP16_STATIC uint16_t fp16_round_(int sgn, int exp, uint32_t mnt, int rm, int mode, int *flags)
 {
-    int a_sgn, a_exp, b_sgn, b_exp, x_sgn, x_exp;
-    uint16_t a_mnt, b_mnt, x;
+    if (exp < 1) {
+        if (mode & FP_FZ16) {
+            *flags |= FP_UFC;
+            return FP16_CONSTRUCTOR(sgn, 0, 0);
+        }
+        mnt = Shrsticky32(mnt, 1 - exp);
+        exp = 1;
+        if (mnt & 0xF) {
+            *flags |= FP_UFC;
+        }
+    }
+    if (mnt & 0xF) {
+        *flags |= FP_IXC;
+    }
+
+    uint32_t man = (mnt >> 4) + ((rtab[rm & 3] >> ((mnt & 0x1F) << 1 | sgn)) & 1);
+    if (man >> (FP16_MAN_LEN + 1)) {
+        man >>= 1;
+        ++exp;
+    }
+    if (!(man & FP16_MAN_HIDE_BIT)) {
+        exp = 0;
+    }
+    if (exp >= FP16_MAX_EXP) {
+        *flags |= FP_OFC | FP_IXC;
+        return FP16_CONSTRUCTOR(sgn, FP16_MAX_EXP - 1, FP16_MAX_MAN);
+    }
+    return FP16_CONSTRUCTOR(sgn, exp, man);
+}
+
+FP16_INLINE uint16_t fp16_div(uint16_t a, uint16_t b, int mode, int *flags)
+{
+    int a_sgn, a_exp, b_sgn, b_exp, x_sgn, x_exp, shift;
+    uint16_t a_mnt, b_mnt;
     uint32_t x_mnt;
 
     fp16_unpack(&a_sgn, &a_exp, &a_mnt, a, mode, flags);
     fp16_unpack(&b_sgn, &b_exp, &b_mnt, b, mode, flags);
+    x_sgn = a_sgn ^ b_sgn;
 
-    //if ((x = fp16_process_NaNs(a, b, mode, flags)))
-    //    return x;
-
-    // Handle infinities and zeroes:
-    if ((a_exp == 31 && b_exp == 31) || (!a_mnt && !b_mnt)) {
-        *flags |= FPLIB_IOC;
-        return fp16_defaultNaN();
+    // No inf in fp16_t: division by zero saturates, zero dividend gives +0
+    if (!b_mnt) {
+        *flags |= FP_DZC;
+        return FP16_CONSTRUCTOR(x_sgn, FP16_MAX_EXP - 1, FP16_MAX_MAN);
     }
-    if (a_exp == 31 || !b_mnt) {
-        if (a_exp != 31)
-            *flags |= FPLIB_DZC;
-        return fp16_infinity(a_sgn ^ b_sgn);
+    if (!a_mnt) {
+        return 0;
     }
-    if (!a_mnt || b_exp == 31)
-        return fp16_zero(a_sgn ^ b_sgn);
 
-    // Divide, setting bottom bit if inexact:
+    // Divide, setting bottom bit if inexact, quotient is (2^13, 2^15):
     a_mnt = fp16_normalise(a_mnt, &a_exp);
-    x_sgn = a_sgn ^ b_sgn;
-    x_exp = a_exp - b_exp + 36;
-    x_mnt = ((uint32_t)a_mnt << 10) / b_mnt;
-    x_mnt |= (x_mnt * b_mnt != (uint32_t)a_mnt << 10);
+    b_mnt = fp16_normalise(b_mnt, &b_exp);
+    x_mnt = ((uint32_t)a_mnt << 14) / b_mnt;
+    x_mnt |= (x_mnt * b_mnt != (uint32_t)a_mnt << 14);
 
-    // Normalise and convert to 32 bits, collapsing error into bottom bit:
-    x_mnt = fp32_normalise(x_mnt, &x_exp);
-    x_mnt = x_mnt >> 15 | !!(uint16_t)(x_mnt << 1);
+    // Normalise leading one to bit 14:
+    shift = (x_mnt >> 14) ^ 1;
+    x_mnt <<= shift;
+    x_exp = a_exp - b_exp + FP16_EXP_BIAS - shift;
 
-    uint16_t ret = fp16_round_(x_sgn, x_exp, x_mnt, mode&3,mode, flags);
-    return ret;
+    return fp16_round_(x_sgn, x_exp, x_mnt, mode & 3, mode, flags);
 }
-//http://www.gem5.org/docs/html/fplib_8cc_source.html
+
+#endif /*_FP16DIV_CC_*/
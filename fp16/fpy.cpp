@@ -46,6 +46,13 @@
         return NULL;                            \
     }                                           \
 
+#define PREPARE_WRAPP_ACT_PARA                  \
+    int x, round = ACT_ROUND_SINGLE;            \
+    if (!PyArg_ParseTuple(args, "i|i", &x, &round))\
+    {                                           \
+        return NULL;                            \
+    }                                           \
+
 #define PREPARE_WRAPP_TWO_UINT_PARA             \
     uint32_t ux, uy;                            \
     if (!PyArg_ParseTuple(args, "ll", &ux, &uy))\
@@ -74,7 +81,13 @@ typedef enum tagFPMathMethodType{
     MATH_POW2,
     MATH_POW10,
     MATH_SIN,
-    MATH_COS
+    MATH_COS,
+    MATH_SIGMOID,
+    MATH_TANH,
+    MATH_GELU,
+    MATH_GELU_TANH,
+    MATH_SILU,
+    MATH_SOFTPLUS
 } FPMathMethodType;
 
 int Compare(int x, int y, fp16CompareType type){
@@ -276,6 +289,24 @@ int UInt32ToFP16(uint32_t ux){
     return ret;
 }
 
+int Fp16Activation(int x, FPMathMethodType mathType, int round){
+    PREPARE_ONE_FP16_PARA
+    fp16ActRound_t actRound = (ACT_ROUND_COMPOSED == round) ? ACT_ROUND_COMPOSED : ACT_ROUND_SINGLE;
+    switch (mathType)
+    {
+        case MATH_SIGMOID:   fpRet = hf_sigmoid(fp, actRound);   break;
+        case MATH_TANH:      fpRet = hf_tanh(fp, actRound);      break;
+        case MATH_GELU:      fpRet = hf_gelu(fp, actRound);      break;
+        case MATH_GELU_TANH: fpRet = hf_geluTanh(fp, actRound);  break;
+        case MATH_SILU:      fpRet = hf_silu(fp, actRound);      break;
+        case MATH_SOFTPLUS:  fpRet = hf_softplus(fp, actRound);  break;
+        default:             fpRet.val = 0;                      break;
+    }
+    ret = fpRet.val;
+    result = ret;
+    return result;
+}
+
 int Fp16Math(int x, FPMathMethodType mathType){
     PREPARE_ONE_FP16_PARA
     switch (mathType)
@@ -804,6 +835,36 @@ PyObject* WrappCos(PyObject* self, PyObject* args)
     PREPARE_WRAPP_ONE_INT_PARA
     return Py_BuildValue("i", Fp16Math(x, MATH_COS));
 }
+PyObject* WrappSigmoid(PyObject* self, PyObject* args)
+{
+    PREPARE_WRAPP_ACT_PARA
+    return Py_BuildValue("i", Fp16Activation(x, MATH_SIGMOID, round));
+}
+PyObject* WrappTanh(PyObject* self, PyObject* args)
+{
+    PREPARE_WRAPP_ACT_PARA
+    return Py_BuildValue("i", Fp16Activation(x, MATH_TANH, round));
+}
+PyObject* WrappGelu(PyObject* self, PyObject* args)
+{
+    PREPARE_WRAPP_ACT_PARA
+    return Py_BuildValue("i", Fp16Activation(x, MATH_GELU, round));
+}
+PyObject* WrappGeluTanh(PyObject* self, PyObject* args)
+{
+    PREPARE_WRAPP_ACT_PARA
+    return Py_BuildValue("i", Fp16Activation(x, MATH_GELU_TANH, round));
+}
+PyObject* WrappSilu(PyObject* self, PyObject* args)
+{
+    PREPARE_WRAPP_ACT_PARA
+    return Py_BuildValue("i", Fp16Activation(x, MATH_SILU, round));
+}
+PyObject* WrappSoftplus(PyObject* self, PyObject* args)
+{
+    PREPARE_WRAPP_ACT_PARA
+    return Py_BuildValue("i", Fp16Activation(x, MATH_SOFTPLUS, round));
+}
 PyObject* WrappMax(PyObject* self, PyObject* args)
 {
     PREPARE_WRAPP_TWO_INT_PARA
@@ -1067,6 +1128,13 @@ static PyMethodDef fpy_methods[] = {
     { "Pow10",        WrappPow10, METH_VARARGS, "calculates fp16_t decimal exponential" },
     { "Sin",          WrappSin,   METH_VARARGS, "calculates fp16_t sine" },
     { "Cos",          WrappCos,   METH_VARARGS, "calculates fp16_t cosine" },
+    /*optional second parameter 1 rounds every intermediate to fp16_t as Exp/Add/Div do, 0 rounds once*/
+    { "Sigmoid",      WrappSigmoid,  METH_VARARGS, "calculates fp16_t sigmoid" },
+    { "Tanh",         WrappTanh,     METH_VARARGS, "calculates fp16_t hyperbolic tangent" },
+    { "Gelu",         WrappGelu,     METH_VARARGS, "calculates fp16_t GELU, erf form" },
+    { "GeluTanh",     WrappGeluTanh, METH_VARARGS, "calculates fp16_t GELU, tanh form" },
+    { "Silu",         WrappSilu,     METH_VARARGS, "calculates fp16_t SiLU" },
+    { "Softplus",     WrappSoftplus, METH_VARARGS, "calculates fp16_t softplus" },
     { "Max",          WrappMax,   METH_VARARGS, "calculates the maximum fp16_t" },
     { "Min",          WrappMin,   METH_VARARGS, "calculates the minimum fp16_t" },
     { "Deq",          WrappDeq,   METH_VARARGS, "DEQ:convert_s32_to_f16*DEQSCALE, and the result exponent + 17" },
@@ -1137,6 +1205,10 @@ void initfpy()
 #endif
 
 /***compile command：****************************************************************************************************/
-/***g++ -std=c++11 -fPIC -shared fp16_t.cc fp16_math.cc fp16_unit.cc fpy.cpp -I/usr/include/python2.7 -o fpy.so**********/
-/***g++ -std=c++11 -fPIC -shared fp16_t.cc fp16_math.cc fp16_unit.cc fpy.cpp -I/usr/include/python3.5 -o fpy.so**********/
+/***g++ -std=c++11 -fPIC -shared fp16_t.cc fp16_math.cc fp16_unit.cc fp16_array.cc fp16div.cc fp16_table.cc fp16_simd.cc*/
+/***    fpy.cpp -I/usr/include/python2.7 -lpthread -o fpy.so*************************************************************/
+/***g++ -std=c++11 -fPIC -shared fp16_t.cc fp16_math.cc fp16_unit.cc fp16_array.cc fp16div.cc fp16_table.cc fp16_simd.cc*/
+/***    fpy.cpp -I/usr/include/python3.5 -lpthread -o fpy.so*************************************************************/
+/***fp16_t.cc calls fp16div.cc, fp16_math.cc calls fp16_table.cc, fp16_array.cc calls fp16_simd.cc and fp16_unit.cc******/
+/***calls all of them with -lpthread; a new call between sources is added to both lines in the same change***************/
 /************************************************************************************************************************/